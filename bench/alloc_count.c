@@ -0,0 +1,43 @@
+// Counts heap calls made by everything linked into the bench, so suites can
+// check that a hot path doesn't allocate. The link wraps these symbols with
+// -Wl,--wrap; calls made from inside libc itself aren't seen.
+#include "bench.h"
+#include <stdatomic.h>
+#include <stdlib.h>
+
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t count, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+void *__real_aligned_alloc(size_t align, size_t size);
+void  __real_free(void *ptr);
+
+static atomic_ullong alloc_calls;
+
+void *__wrap_malloc(size_t size) {
+    atomic_fetch_add_explicit(&alloc_calls, 1, memory_order_relaxed);
+    return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t count, size_t size) {
+    atomic_fetch_add_explicit(&alloc_calls, 1, memory_order_relaxed);
+    return __real_calloc(count, size);
+}
+
+void *__wrap_realloc(void *ptr, size_t size) {
+    atomic_fetch_add_explicit(&alloc_calls, 1, memory_order_relaxed);
+    return __real_realloc(ptr, size);
+}
+
+void *__wrap_aligned_alloc(size_t align, size_t size) {
+    atomic_fetch_add_explicit(&alloc_calls, 1, memory_order_relaxed);
+    return __real_aligned_alloc(align, size);
+}
+
+void __wrap_free(void *ptr) {
+    if (ptr) atomic_fetch_add_explicit(&alloc_calls, 1, memory_order_relaxed);
+    __real_free(ptr);
+}
+
+uint64_t bench_alloc_calls(void) {
+    return atomic_load_explicit(&alloc_calls, memory_order_relaxed);
+}
@@ -0,0 +1,69 @@
+#include "bench.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Suite table, run in this order when no suite is named
+static const struct {
+    const char *name;
+    BenchFunc   func;
+} suites[] = {
+    { "frame",     bench_frame     },
+    { "transform", bench_transform },
+    { "bvh",       bench_bvh       },
+    { "jobs",      bench_jobs      },
+    { "stream",    bench_stream    },
+    { "raster",    bench_raster    },
+    { "meshlet",   bench_meshlet   },
+    { "golden",    bench_golden    },
+};
+#define NUM_SUITES (sizeof(suites) / sizeof(suites[0]))
+
+static int compare_double(const void *a, const void *b) {
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+void bench_report(const char *name, double *samples_ms, size_t count) {
+    if (count == 0) return;
+    qsort(samples_ms, count, sizeof(double), compare_double);
+
+    double sum = 0.0;
+    for (size_t i = 0; i < count; i++) sum += samples_ms[i];
+
+    printf("  %-16s min %9.4f  avg %9.4f  p50 %9.4f  p99 %9.4f  max %9.4f ms\n",
+           name,
+           samples_ms[0],
+           sum / (double)count,
+           samples_ms[count / 2],
+           samples_ms[(count * 99) / 100],
+           samples_ms[count - 1]);
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr, "usage: %s [suite [args...]]\nsuites:", prog);
+    for (size_t i = 0; i < NUM_SUITES; i++) fprintf(stderr, " %s", suites[i].name);
+    fprintf(stderr, "\n");
+}
+
+int main(int argc, char *argv[]) {
+    // No suite named: run everything with default arguments
+    if (argc < 2) {
+        int result = 0;
+        for (size_t i = 0; i < NUM_SUITES; i++) {
+            printf("[%s]\n", suites[i].name);
+            result |= suites[i].func(0, NULL);
+        }
+        return result;
+    }
+
+    for (size_t i = 0; i < NUM_SUITES; i++) {
+        if (strcmp(argv[1], suites[i].name) == 0) {
+            printf("[%s]\n", suites[i].name);
+            return suites[i].func(argc - 2, argv + 2);
+        }
+    }
+    usage(argv[0]);
+    return 1;
+}
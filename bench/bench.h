@@ -0,0 +1,33 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// A benchmark suite. argv holds the arguments after the suite name.
+// Returns 0 on success.
+typedef int (*BenchFunc)(int argc, char *argv[]);
+
+// Suites
+int bench_frame(int argc, char *argv[]);
+int bench_transform(int argc, char *argv[]);
+int bench_bvh(int argc, char *argv[]);
+int bench_jobs(int argc, char *argv[]);
+int bench_stream(int argc, char *argv[]);
+int bench_raster(int argc, char *argv[]);
+int bench_meshlet(int argc, char *argv[]);
+int bench_golden(int argc, char *argv[]);
+
+// Print min/avg/p50/p99/max of a set of millisecond samples. Sorts samples.
+void bench_report(const char *name, double *samples_ms, size_t count);
+
+// malloc/calloc/realloc/aligned_alloc/free calls (non-NULL frees only) made
+// since startup, on any thread
+uint64_t bench_alloc_calls(void);
+
+// True if the app has called sapp_quit() since the last call, i.e. its init
+// failed (headless.c)
+bool     headless_quit_requested(void);
+
+#endif // BENCH_H
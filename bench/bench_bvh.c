@@ -0,0 +1,215 @@
+// BVH build/refit and query cost as the scene grows, against the linear
+// frustum culling pass. Entities are spread at constant density, so a query
+// finds about as many neighbours at every size and only the search grows.
+// Fails if the BVH's visible set or pick hits differ from a linear pass.
+#include "bench.h"
+#include "bvh.h"
+#include "camera.h"
+#include "scene.h"
+#include "sokol_time.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define BVH_DEFAULT_MAX_COUNT 1000000
+#define BVH_MIN_COUNT         1000
+#define BVH_RUNS              20
+#define BVH_BUILD_RUNS        5
+#define BVH_QUERIES           1000
+#define BVH_SPACING           2.0f
+#define BVH_QUERY_RADIUS      5.0f
+#define BVH_MOVED_PERCENT     1
+#define BVH_CHECK_STRIDE      10  // every 10th pick ray is checked against every sphere
+
+static float frand(float lo, float hi) {
+    return lo + (hi - lo) * (float)rand() / (float)RAND_MAX;
+}
+
+static int compare_u32(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+// Point the camera somewhere random; picks cast along its forward vector
+static void aim(Camera *cam) {
+    cam->yaw   = frand(-HMM_PI, HMM_PI);
+    cam->pitch = frand(-cam->pitch_max, cam->pitch_max);
+}
+
+// Nearest hit by testing every sphere, with bvh_raycast()'s leaf test
+static bool raycast_linear(const Scene *scene, HMM_Vec3 origin, HMM_Vec3 dir, float max_t, BvhHit *hit) {
+    bool found = false;
+    for (uint32_t e = 0; e < scene->count; e++) {
+        HMM_Vec3 oc = HMM_SubV3(HMM_V3(scene->sphere_x[e], scene->sphere_y[e], scene->sphere_z[e]), origin);
+        float    r  = scene->sphere_radius[e];
+        float    tc = HMM_DotV3(oc, dir);
+        float    d2 = HMM_DotV3(oc, oc) - tc * tc;
+        if (d2 > r * r) continue;
+        float half = sqrtf(r * r - d2);
+        float t    = tc - half >= 0.0f ? tc - half : tc + half;
+        if (t < 0.0f || t >= max_t) continue;
+        max_t = t;
+        found = true;
+        *hit  = (BvhHit){ .entity = e, .t = t };
+    }
+    return found;
+}
+
+static bool bench_count(uint32_t count, double *samples) {
+    Scene scene;
+    if (!scene_init(&scene, count)) {
+        fprintf(stderr, "bvh: out of memory for %u entities\n", count);
+        return false;
+    }
+    srand(1);
+    float half = cbrtf((float)count) * BVH_SPACING * 0.5f;
+    for (uint32_t i = 0; i < count; i++) {
+        HMM_Vec3 pos = HMM_V3(frand(-half, half), frand(-half, half), frand(-half, half));
+        scene_add(&scene, pos, HMM_Q(0.0f, 0.0f, 0.0f, 1.0f), HMM_V3(1.0f, 1.0f, 1.0f), 0, 0);
+        scene_set_bounds(&scene, i, HMM_V3(0.0f, 0.0f, 0.0f), 0.5f);
+    }
+    scene_update_transforms(&scene, NULL);
+
+    Bvh bvh;
+    bvh_init(&bvh, count);
+    uint32_t *visible   = malloc(count * sizeof(uint32_t));
+    uint32_t *reference = malloc(count * sizeof(uint32_t));
+    bool      ok        = true;
+    char      name[64];
+
+    printf("  %u entities\n", count);
+
+    for (int r = 0; r < BVH_BUILD_RUNS; r++) {
+        uint64_t start = stm_now();
+        bvh_build(&bvh, &scene);
+        samples[r] = stm_ms(stm_since(start));
+    }
+    bench_report("build", samples, BVH_BUILD_RUNS);
+
+    for (int r = 0; r < BVH_RUNS; r++) {
+        uint64_t start = stm_now();
+        bvh_refit(&bvh, &scene);
+        samples[r] = stm_ms(stm_since(start));
+    }
+    bench_report("refit", samples, BVH_RUNS);
+
+    // Nudge a few entities each run and refit only their paths
+    uint32_t *moved = malloc(count * sizeof(uint32_t));
+    for (int r = 0; r < BVH_RUNS; r++) {
+        for (uint32_t i = 0; i < count; i += 100 / BVH_MOVED_PERCENT) {
+            scene.pos_x[i] += (r & 1) ? -0.1f : 0.1f;
+        }
+        uint32_t moved_count = scene_update_transforms(&scene, moved);
+        uint64_t start       = stm_now();
+        bvh_refit_moved(&bvh, &scene, moved, moved_count);
+        samples[r] = stm_ms(stm_since(start));
+    }
+    free(moved);
+    snprintf(name, sizeof(name), "refit %d%% moved", BVH_MOVED_PERCENT);
+    bench_report(name, samples, BVH_RUNS);
+
+    // Camera at the centre looking down -Z, default far plane
+    Camera camera;
+    camera_init(&camera, HMM_V3(0.0f, 0.0f, 0.0f), HMM_PI);
+    Frustum frustum = frustum_from_matrix(HMM_MulM4(camera_projection(&camera, 4.0f / 3.0f), camera_view(&camera)));
+
+    uint32_t linear_visible = 0;
+    for (int r = 0; r < BVH_RUNS; r++) {
+        uint64_t start = stm_now();
+        linear_visible = frustum_cull_spheres(&frustum, scene.sphere_x, scene.sphere_y, scene.sphere_z,
+                                              scene.sphere_radius, scene.count, reference);
+        samples[r] = stm_ms(stm_since(start));
+    }
+    bench_report("cull linear", samples, BVH_RUNS);
+
+    uint32_t bvh_visible = 0;
+    for (int r = 0; r < BVH_RUNS; r++) {
+        uint64_t start = stm_now();
+        bvh_visible = bvh_cull_frustum(&bvh, &scene, &frustum, visible);
+        samples[r] = stm_ms(stm_since(start));
+    }
+    bench_report("cull bvh", samples, BVH_RUNS);
+    printf("  %-16s visible %u linear, %u bvh\n", "", linear_visible, bvh_visible);
+    qsort(reference, linear_visible, sizeof(uint32_t), compare_u32);
+    qsort(visible, bvh_visible, sizeof(uint32_t), compare_u32);
+    if (bvh_visible != linear_visible || memcmp(visible, reference, bvh_visible * sizeof(uint32_t)) != 0) {
+        fprintf(stderr, "bvh: %u entities: visible set differs from the linear pass\n", count);
+        ok = false;
+    }
+
+    uint32_t hits = 0;
+    for (int r = 0; r < BVH_RUNS; r++) {
+        srand(2);
+        hits = 0;
+        uint64_t start = stm_now();
+        for (int q = 0; q < BVH_QUERIES; q++) {
+            aim(&camera);
+            BvhHit hit;
+            hits += bvh_raycast(&bvh, &scene, camera.position, camera_forward(&camera), camera.far_plane, &hit);
+        }
+        samples[r] = stm_ms(stm_since(start));
+    }
+    snprintf(name, sizeof(name), "ray x%d", BVH_QUERIES);
+    bench_report(name, samples, BVH_RUNS);
+    printf("  %-16s %u hits\n", "", hits);
+
+    // The same rays again, untimed, a sample of them against every sphere
+    srand(2);
+    uint32_t ray_mismatches = 0;
+    for (int q = 0; q < BVH_QUERIES; q++) {
+        aim(&camera);
+        if (q % BVH_CHECK_STRIDE != 0) continue;
+        HMM_Vec3 dir = camera_forward(&camera);
+        BvhHit   hit = {0}, expected = {0};
+        bool     found = bvh_raycast(&bvh, &scene, camera.position, dir, camera.far_plane, &hit);
+        if (found != raycast_linear(&scene, camera.position, dir, camera.far_plane, &expected) ||
+            (found && hit.entity != expected.entity && hit.t != expected.t)) {
+            ray_mismatches++;
+        }
+    }
+    if (ray_mismatches > 0) {
+        fprintf(stderr, "bvh: %u entities: %u of %d pick rays disagree with the linear pass\n", count,
+                ray_mismatches, BVH_QUERIES / BVH_CHECK_STRIDE);
+        ok = false;
+    }
+
+    uint32_t found = 0;
+    for (int r = 0; r < BVH_RUNS; r++) {
+        srand(3);
+        found = 0;
+        uint64_t start = stm_now();
+        for (int q = 0; q < BVH_QUERIES; q++) {
+            HMM_Vec3 c = HMM_V3(frand(-half, half), frand(-half, half), frand(-half, half));
+            found += bvh_query_radius(&bvh, &scene, c, BVH_QUERY_RADIUS, visible, count);
+        }
+        samples[r] = stm_ms(stm_since(start));
+    }
+    snprintf(name, sizeof(name), "radius x%d", BVH_QUERIES);
+    bench_report(name, samples, BVH_RUNS);
+    printf("  %-16s %u found\n", "", found);
+
+    free(reference);
+    free(visible);
+    bvh_free(&bvh);
+    scene_free(&scene);
+    return ok;
+}
+
+// bench bvh [max_count]: sizes from BVH_MIN_COUNT up to max_count, x10 apart
+int bench_bvh(int argc, char *argv[]) {
+    uint32_t max_count = argc > 0 ? (uint32_t)atoi(argv[0]) : BVH_DEFAULT_MAX_COUNT;
+    if (max_count < BVH_MIN_COUNT) {
+        fprintf(stderr, "bvh: max count must be at least %d\n", BVH_MIN_COUNT);
+        return 1;
+    }
+    stm_setup();
+
+    double *samples = malloc(BVH_RUNS * sizeof(double));
+    int     result  = 0;
+    for (uint32_t count = BVH_MIN_COUNT; count <= max_count && result == 0; count *= 10) {
+        if (!bench_count(count, samples)) result = 1;
+    }
+    free(samples);
+    return result;
+}
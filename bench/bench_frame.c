@@ -0,0 +1,131 @@
+// Drives main.c's init()/frame()/cleanup() through the sapp_desc returned by
+// sokol_main(), exactly as sokol_app would, and reports per-phase CPU time.
+#include "bench.h"
+#include "frame_timing.h"
+#include "texture.h"
+#include "sokol_app.h"
+#include "sokol_time.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define FRAME_DEFAULT_COUNT  1000
+#define FRAME_WARMUP_COUNT   10
+#define FRAME_LOAD_TIMEOUT_S 30.0
+#define BENCH_FRAME_MAX_ARGS 16
+
+static const char *phase_names[FRAME_PHASE_COUNT] = {
+    [FRAME_PHASE_UPDATE] = "update",
+    [FRAME_PHASE_BUILD]  = "build",
+    [FRAME_PHASE_CULL]   = "cull",
+    [FRAME_PHASE_RECORD] = "record",
+    [FRAME_PHASE_SUBMIT] = "submit",
+};
+
+static const char *gpu_names[FRAME_GPU_COUNT] = {
+    [FRAME_GPU_MAIN] = "gpu main",
+};
+
+static const char *counter_names[FRAME_COUNTER_COUNT] = {
+    [FRAME_COUNTER_DRAWS]            = "draws",
+    [FRAME_COUNTER_PIPELINES]        = "pipelines",
+    [FRAME_COUNTER_PIPELINES_ELIDED] = "pipelines elided",
+    [FRAME_COUNTER_BINDINGS]         = "bindings",
+    [FRAME_COUNTER_BINDINGS_ELIDED]  = "bindings elided",
+    [FRAME_COUNTER_OCCLUDED]         = "occluded",
+    [FRAME_COUNTER_TRIANGLES]        = "triangles",
+    [FRAME_COUNTER_MESHLETS_CULLED]  = "meshlets culled",
+};
+
+// bench frame [count] [key=value ...]: options after the frame count go to
+// sokol_main() as the app's command line, e.g. instances=100000. Fails if
+// any timed frame touched the heap.
+int bench_frame(int argc, char *argv[]) {
+    int frames = FRAME_DEFAULT_COUNT;
+    if (argc > 0 && !strchr(argv[0], '=')) {
+        frames = atoi(argv[0]);
+        argc--, argv++;
+    }
+    if (frames <= 0) {
+        fprintf(stderr, "frame: frame count must be positive\n");
+        return 1;
+    }
+
+    double *samples[FRAME_PHASE_COUNT + 1];
+    double *gpu_samples[FRAME_GPU_COUNT];
+    for (int p = 0; p <= FRAME_PHASE_COUNT; p++) {
+        samples[p] = malloc((size_t)frames * sizeof(double));
+    }
+    for (int p = 0; p < FRAME_GPU_COUNT; p++) {
+        gpu_samples[p] = malloc((size_t)frames * sizeof(double));
+    }
+
+    char *app_argv[BENCH_FRAME_MAX_ARGS + 1] = { "bench" };
+    int   app_argc = 1;
+    for (int i = 0; i < argc && app_argc < BENCH_FRAME_MAX_ARGS; i++) app_argv[app_argc++] = argv[i];
+    sapp_desc desc = sokol_main(app_argc, app_argv);
+    desc.init_cb();
+    if (headless_quit_requested()) {
+        desc.cleanup_cb();
+        for (int p = 0; p <= FRAME_PHASE_COUNT; p++) free(samples[p]);
+        for (int p = 0; p < FRAME_GPU_COUNT; p++) free(gpu_samples[p]);
+        fprintf(stderr, "frame: app init failed\n");
+        return 1;
+    }
+
+    desc.frame_cb();
+    double first_frame_ms = stm_ms(frame_timing_first_frame());
+
+    // Without a cooked .tex the texture decodes in the background and its
+    // upload and free land in some later frame; finish it before warmup so
+    // the timed frames only measure steady state
+    uint64_t load_start = stm_now();
+    while (texture_pending() && stm_sec(stm_since(load_start)) < FRAME_LOAD_TIMEOUT_S) desc.frame_cb();
+    for (int i = 1; i < FRAME_WARMUP_COUNT; i++) desc.frame_cb();
+
+    uint64_t counters[FRAME_COUNTER_COUNT] = {0};
+    uint64_t alloc_calls = 0;
+    for (int i = 0; i < frames; i++) {
+        uint64_t before = bench_alloc_calls();
+        desc.frame_cb();
+        alloc_calls += bench_alloc_calls() - before;
+        const FrameTiming *t = frame_timing_last();
+        for (int p = 0; p < FRAME_PHASE_COUNT; p++) {
+            samples[p][i] = stm_ms(t->phase[p]);
+        }
+        samples[FRAME_PHASE_COUNT][i] = stm_ms(t->total);
+        for (int p = 0; p < FRAME_GPU_COUNT; p++) gpu_samples[p][i] = (double)t->gpu[p] * 1e-6;
+        for (int c = 0; c < FRAME_COUNTER_COUNT; c++) counters[c] += t->counters[c];
+    }
+
+    desc.cleanup_cb();
+
+    printf("  %d frames (dummy backend)\n", frames);
+    printf("  %-16s %9.4f ms\n", "first frame", first_frame_ms);
+    for (int p = 0; p < FRAME_PHASE_COUNT; p++) {
+        bench_report(phase_names[p], samples[p], (size_t)frames);
+    }
+    bench_report("total", samples[FRAME_PHASE_COUNT], (size_t)frames);
+
+    // GPU timings only exist on backends with timer queries
+    for (int p = 0; p < FRAME_GPU_COUNT; p++) {
+        if (gpu_samples[p][frames - 1] > 0.0) {
+            bench_report(gpu_names[p], gpu_samples[p], (size_t)frames);
+        } else {
+            printf("  %-16s unavailable on this backend\n", gpu_names[p]);
+        }
+    }
+    for (int c = 0; c < FRAME_COUNTER_COUNT; c++) {
+        printf("  %-16s %9.1f per frame\n", counter_names[c], (double)counters[c] / frames);
+    }
+
+    printf("  %-16s %9llu in timed frames\n", "heap calls", (unsigned long long)alloc_calls);
+
+    for (int p = 0; p <= FRAME_PHASE_COUNT; p++) free(samples[p]);
+    for (int p = 0; p < FRAME_GPU_COUNT; p++) free(gpu_samples[p]);
+    if (alloc_calls > 0) {
+        fprintf(stderr, "frame: %llu heap calls in timed frames, expected none\n", (unsigned long long)alloc_calls);
+        return 1;
+    }
+    return 0;
+}
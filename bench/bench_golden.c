@@ -0,0 +1,125 @@
+// Golden-image checks: runs the app headless with capture=, which renders a
+// frame's recorded draws on the CPU rasterizer, and compares the PNG with a
+// reference in data/golden. Cases that render the same scene through
+// different paths (instanced, separate draws, pulled MVPs, more threads,
+// occlusion and meshlet culling) share one reference, so an optimization
+// that changes the picture fails here. LOD selection changes the picture by
+// design, so it gets its own reference that both draw paths must agree on.
+// The pyramid is a single meshlet, so meshlet culling is checked on a dense
+// sphere as well. Cases without a reference must fail init instead, as on a
+// missing asset.
+#include "bench.h"
+#include "image.h"
+#include "sokol_app.h"
+#include "stb_image.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define GOLDEN_DIR        "data/golden"
+#define GOLDEN_OUT_DIR    "build"
+#define GOLDEN_FRAME      30
+#define GOLDEN_MAX_ARGS   8
+#define SPHERE_MESH       "mesh=data/meshes/sphere.mesh"
+
+// A channel may differ by this much, and this many pixels in 10000 by more,
+// to absorb edge pixels flipping between paths that round differently
+#define GOLDEN_TOLERANCE         8
+#define GOLDEN_MAX_DIFFERING_BP  1
+
+static const struct {
+    const char *name;
+    const char *reference;
+    const char *args[GOLDEN_MAX_ARGS];
+} cases[] = {
+    { "single",             "single",    { 0 } },
+    { "grid",               "grid",      { "instances=1000" } },
+    { "grid separate",      "grid",      { "instances=1000", "instancing=off" } },
+    { "grid separate t=4",  "grid",      { "instances=1000", "instancing=off", "threads=3" } },
+    { "grid pulled",        "grid",      { "instances=1000", "instancing=off", "pulled=on" } },
+    { "occluders",          "occluders", { "instances=1000", "occluders=3", "occlusion=off" } },
+    { "occluded",           "occluders", { "instances=1000", "occluders=3" } },
+    { "occluded separate",  "occluders", { "instances=1000", "occluders=3", "instancing=off" } },
+    { "lod",                "lod",       { "instances=1000", "lod_error=20" } },
+    { "lod separate",       "lod",       { "instances=1000", "lod_error=20", "instancing=off" } },
+    { "grid meshlets",      "grid",      { "instances=1000", "instancing=off", "meshlets=on" } },
+    { "lod meshlets t=4",   "lod",       { "instances=1000", "lod_error=20", "instancing=off", "meshlets=on",
+                                           "threads=3" } },
+    { "spheres",            "spheres",   { "instances=1000", "instancing=off", SPHERE_MESH } },
+    { "spheres meshlets",   "spheres",   { "instances=1000", "instancing=off", SPHERE_MESH, "meshlets=on" } },
+    { "spheres meshlets t=4", "spheres", { "instances=1000", "instancing=off", SPHERE_MESH, "meshlets=on",
+                                           "threads=3" } },
+    { "missing mesh",       NULL,        { "mesh=data/meshes/missing.mesh" } },
+    { "scene too large",    NULL,        { "instances=2000000" } },
+};
+#define NUM_CASES (sizeof(cases) / sizeof(cases[0]))
+
+// Run the app until it has captured frame GOLDEN_FRAME to path. False if
+// its init failed.
+static bool render(size_t c, const char *path) {
+    char  capture[320], frame[32];
+    char *argv[GOLDEN_MAX_ARGS + 3] = { "bench", capture, frame };
+    int   argc = 3;
+    snprintf(capture, sizeof(capture), "capture=%s", path);
+    snprintf(frame, sizeof(frame), "capture_frame=%d", GOLDEN_FRAME);
+    for (int i = 0; i < GOLDEN_MAX_ARGS && cases[c].args[i]; i++) argv[argc++] = (char *)cases[c].args[i];
+
+    sapp_desc desc = sokol_main(argc, argv);
+    desc.init_cb();
+    bool started = !headless_quit_requested();
+    for (int i = 0; started && i <= GOLDEN_FRAME; i++) desc.frame_cb();
+    desc.cleanup_cb();
+    return started;
+}
+
+// bench golden [update]: update rewrites the references from the first case
+// using each, then checks the rest against them
+int bench_golden(int argc, char *argv[]) {
+    bool update = argc > 0 && strcmp(argv[0], "update") == 0;
+    int  result = 0;
+    for (size_t c = 0; c < NUM_CASES; c++) {
+        char reference[256], output[256];
+        snprintf(output, sizeof(output), GOLDEN_OUT_DIR "/golden_%zu.png", c);
+        if (!cases[c].reference) {
+            bool started = render(c, output);
+            printf("  %-20s %s  init %s\n", cases[c].name, started ? "FAIL" : "ok  ",
+                   started ? "succeeded, expected a failure" : "failed as expected");
+            if (started) result = 1;
+            continue;
+        }
+        snprintf(reference, sizeof(reference), GOLDEN_DIR "/%s.png", cases[c].reference);
+
+        bool first = true;
+        for (size_t k = 0; k < c; k++) {
+            first &= !cases[k].reference || strcmp(cases[k].reference, cases[c].reference) != 0;
+        }
+        if (!render(c, update && first ? reference : output)) {
+            printf("  %-20s FAIL init failed\n", cases[c].name);
+            result = 1;
+            continue;
+        }
+        if (update && first) {
+            printf("  %-20s wrote %s\n", cases[c].name, reference);
+            continue;
+        }
+
+        int ref_w, ref_h, out_w, out_h, channels;
+        stbi_uc *ref = stbi_load(reference, &ref_w, &ref_h, &channels, 4);
+        stbi_uc *out = stbi_load(output, &out_w, &out_h, &channels, 4);
+        if (!ref || !out || ref_w != out_w || ref_h != out_h) {
+            printf("  %-20s FAIL %s\n", cases[c].name,
+                   !ref ? "no reference (bench golden update)" : !out ? "no capture" : "size mismatch");
+            result = 1;
+        } else {
+            ImageDiff diff = image_compare((const uint32_t *)out, (uint32_t)out_w, (const uint32_t *)ref,
+                                           (uint32_t)ref_w, (uint32_t)out_w, (uint32_t)out_h, GOLDEN_TOLERANCE);
+            bool pass = (uint64_t)diff.differing * 10000 <= (uint64_t)out_w * out_h * GOLDEN_MAX_DIFFERING_BP;
+            printf("  %-20s %s  max delta %3u  %6u px over tolerance\n", cases[c].name, pass ? "ok  " : "FAIL",
+                   diff.max_delta, diff.differing);
+            if (!pass) result = 1;
+        }
+        stbi_image_free(ref);
+        stbi_image_free(out);
+    }
+    return result;
+}
@@ -0,0 +1,82 @@
+// Job system scaling from one thread up to one per core: a parallel-for over
+// the scene transform update, and raw job throughput with empty jobs.
+#include "bench.h"
+#include "job.h"
+#include "scene.h"
+#include "sokol_time.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#define JOBS_ENTITY_COUNT 1000000
+#define JOBS_GRAIN        4096
+#define JOBS_EMPTY_COUNT  10000
+#define JOBS_RUNS         20
+
+static void update_range(void *data, uint32_t begin, uint32_t end) {
+    scene_update_transforms_range(data, begin, end, NULL);
+}
+
+static void empty_job(void *data) {
+    (void)data;
+}
+
+// bench jobs [max_threads]: defaults to the number of cores
+int bench_jobs(int argc, char *argv[]) {
+    long     cores       = sysconf(_SC_NPROCESSORS_ONLN);
+    uint32_t max_threads = argc > 0 ? (uint32_t)atoi(argv[0]) : (cores > 0 ? (uint32_t)cores : 1);
+    if (max_threads == 0 || max_threads > JOB_MAX_WORKERS + 1) {
+        fprintf(stderr, "jobs: thread count must be 1..%d\n", JOB_MAX_WORKERS + 1);
+        return 1;
+    }
+    stm_setup();
+
+    Scene scene;
+    if (!scene_init(&scene, JOBS_ENTITY_COUNT)) {
+        fprintf(stderr, "jobs: out of memory for %d entities\n", JOBS_ENTITY_COUNT);
+        return 1;
+    }
+    srand(1);
+    for (uint32_t i = 0; i < JOBS_ENTITY_COUNT; i++) {
+        HMM_Vec3 pos = HMM_V3((float)rand() / RAND_MAX, (float)rand() / RAND_MAX, (float)rand() / RAND_MAX);
+        scene_add(&scene, pos, HMM_Q(0.0f, 0.0f, 0.0f, 1.0f), HMM_V3(1.0f, 1.0f, 1.0f), 0, 0);
+        scene_set_bounds(&scene, i, HMM_V3(0.0f, 0.0f, 0.0f), 0.5f);
+    }
+
+    double *samples = malloc(JOBS_RUNS * sizeof(double));
+    double  base_ms = 0.0;
+    char    name[64];
+
+    printf("  %d transforms in chunks of %d, %d empty jobs, %ld cores\n",
+           JOBS_ENTITY_COUNT, JOBS_GRAIN, JOBS_EMPTY_COUNT, cores);
+    for (uint32_t threads = 1; threads <= max_threads; threads++) {
+        job_system_init(threads - 1);
+        job_parallel_for(scene.count, JOBS_GRAIN, update_range, &scene);
+
+        for (int r = 0; r < JOBS_RUNS; r++) {
+            uint64_t start = stm_now();
+            job_parallel_for(scene.count, JOBS_GRAIN, update_range, &scene);
+            samples[r] = stm_ms(stm_since(start));
+        }
+        snprintf(name, sizeof(name), "transforms t=%u", threads);
+        bench_report(name, samples, JOBS_RUNS);
+        if (threads == 1) base_ms = samples[JOBS_RUNS / 2];
+        printf("  %-16s speedup %.2fx\n", "", base_ms / samples[JOBS_RUNS / 2]);
+
+        for (int r = 0; r < JOBS_RUNS; r++) {
+            JobCounter counter = {0};
+            uint64_t   start   = stm_now();
+            for (int j = 0; j < JOBS_EMPTY_COUNT; j++) job_run(empty_job, NULL, &counter);
+            job_wait(&counter);
+            samples[r] = stm_ms(stm_since(start));
+        }
+        snprintf(name, sizeof(name), "empty jobs t=%u", threads);
+        bench_report(name, samples, JOBS_RUNS);
+
+        job_system_shutdown();
+    }
+
+    free(samples);
+    scene_free(&scene);
+    return 0;
+}
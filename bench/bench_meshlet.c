@@ -0,0 +1,127 @@
+// CPU meshlet culling over a grid of dense spheres: how much of each mesh
+// survives the frustum and cone tests, and what the pass costs. Times cover
+// building the per-object view and copying the surviving index runs. Fails
+// if a stretched sphere loses a meshlet that can still be seen.
+#include "bench.h"
+#include "meshlet.h"
+#include "sokol_time.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#define MESHLET_DEFAULT_GRID 32
+#define MESHLET_RUNS         50
+#define MESHLET_SPACING      1.5f
+#define MESHLET_EPSILON      1e-4f
+
+static HMM_Vec3 vertex_at(const MeshData *mesh, HMM_Mat4 world, uint32_t index) {
+    const float *p = mesh->vertices[index].position;
+    return HMM_MulM4V4(world, HMM_V4(p[0], p[1], p[2], 1.0f)).XYZ;
+}
+
+// A culled meshlet must be invisible in world space: all its vertices behind
+// one plane, or all its triangles facing away from the eye
+static bool meshlet_hidden(const MeshData *mesh, const Meshlet *m, const Frustum *frustum, HMM_Vec3 eye,
+                           HMM_Mat4 world) {
+    const MeshHeader *h = mesh->header;
+    uint32_t          index[3];
+    for (int p = 0; p < FRUSTUM_PLANE_COUNT; p++) {
+        HMM_Vec4 plane   = frustum->planes[p];
+        bool     outside = true;
+        for (uint32_t i = m->first_index; i < m->first_index + m->index_count && outside; i++) {
+            index[0] = h->index_size == 2 ? ((const uint16_t *)mesh->indices)[i] : ((const uint32_t *)mesh->indices)[i];
+            outside  = HMM_DotV3(vertex_at(mesh, world, index[0]), plane.XYZ) + plane.W < MESHLET_EPSILON;
+        }
+        if (outside) return true;
+    }
+    for (uint32_t i = m->first_index; i < m->first_index + m->index_count; i += 3) {
+        HMM_Vec3 v[3];
+        for (int k = 0; k < 3; k++) {
+            index[k] = h->index_size == 2 ? ((const uint16_t *)mesh->indices)[i + k]
+                                          : ((const uint32_t *)mesh->indices)[i + k];
+            v[k]     = vertex_at(mesh, world, index[k]);
+        }
+        HMM_Vec3 n = HMM_Cross(HMM_SubV3(v[1], v[0]), HMM_SubV3(v[2], v[0]));
+        if (HMM_DotV3(n, HMM_SubV3(eye, v[0])) > MESHLET_EPSILON * HMM_LenV3(n)) return false;
+    }
+    return true;
+}
+
+// bench meshlet [grid]: grid x grid spheres, viewed like bench raster's grid
+int bench_meshlet(int argc, char *argv[]) {
+    int grid = argc > 0 ? atoi(argv[0]) : MESHLET_DEFAULT_GRID;
+    if (grid <= 0) {
+        fprintf(stderr, "meshlet: grid must be positive\n");
+        return 1;
+    }
+    stm_setup();
+
+    MeshData mesh;
+    if (!mesh_data_map(&mesh, "data/meshes/sphere.mesh")) {
+        fprintf(stderr, "meshlet: failed to load data/meshes/sphere.mesh\n");
+        return 1;
+    }
+    const MeshHeader *h = mesh.header;
+
+    float    extent    = (float)grid * MESHLET_SPACING;
+    HMM_Vec3 eye       = HMM_V3(0.0f, extent * 0.3f, extent * 0.6f);
+    HMM_Mat4 proj      = HMM_Perspective_RH_NO(HMM_AngleDeg(60.0f), 4.0f / 3.0f, 0.1f, extent * 2.0f);
+    HMM_Mat4 view      = HMM_LookAt_RH(eye, HMM_V3(0.0f, 0.0f, 0.0f), HMM_V3(0.0f, 1.0f, 0.0f));
+    Frustum  frustum   = frustum_from_matrix(HMM_MulM4(proj, view));
+
+    uint32_t  count   = (uint32_t)(grid * grid);
+    HMM_Mat4 *world   = malloc(count * sizeof(HMM_Mat4));
+    void     *out     = malloc((size_t)h->lods[0].index_count * h->index_size);
+    double   *samples = malloc(MESHLET_RUNS * sizeof(double));
+    for (uint32_t i = 0; i < count; i++) {
+        float x = ((float)(i % (uint32_t)grid) - (float)grid * 0.5f) * MESHLET_SPACING;
+        float z = ((float)(i / (uint32_t)grid) - (float)grid * 0.5f) * MESHLET_SPACING;
+        world[i] = HMM_MulM4(HMM_Translate(HMM_V3(x, 0.0f, z)), HMM_Rotate_RH((float)i, HMM_V3(0.0f, 1.0f, 0.0f)));
+    }
+
+    uint64_t kept = 0, culled = 0;
+    for (int r = -1; r < MESHLET_RUNS; r++) {
+        uint64_t start = stm_now();
+        uint32_t run_culled = 0;
+        uint64_t run_kept   = 0;
+        for (uint32_t i = 0; i < count; i++) {
+            MeshletView v = meshlet_view(&frustum, eye, world[i]);
+            uint32_t    n = meshlet_cull(&mesh, 0, &v, out, &run_culled);
+            run_kept += n == MESHLET_CULL_NONE ? h->lods[0].index_count : n;
+        }
+        uint64_t end = stm_now();
+        if (r >= 0) samples[r] = stm_ms(stm_diff(end, start));
+        kept   = run_kept;
+        culled = run_culled;
+    }
+
+    // The same grid stretched unevenly, checked against the triangles
+    const MeshLod *lod    = &h->lods[0];
+    uint32_t       wrong  = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        HMM_Mat4    stretched = HMM_MulM4(world[i], HMM_Scale(HMM_V3(0.4f, 1.5f, 0.8f)));
+        MeshletView v         = meshlet_view(&frustum, eye, stretched);
+        for (uint32_t m = lod->first_meshlet; m < lod->first_meshlet + lod->meshlet_count; m++) {
+            if (!meshlet_visible(&v, &mesh.meshlets[m]) &&
+                !meshlet_hidden(&mesh, &mesh.meshlets[m], &frustum, eye, stretched)) {
+                wrong++;
+            }
+        }
+    }
+
+    uint64_t meshlets  = (uint64_t)count * h->lods[0].meshlet_count;
+    uint64_t triangles = (uint64_t)count * h->lods[0].index_count / 3;
+    printf("  %u spheres, %u meshlets of %.1f triangles each\n", count, h->lods[0].meshlet_count,
+           (double)(h->lods[0].index_count / 3) / h->lods[0].meshlet_count);
+    printf("  %-16s %9llu of %llu meshlets culled (%.1f%%)\n", "", (unsigned long long)culled,
+           (unsigned long long)meshlets, 100.0 * (double)culled / (double)meshlets);
+    printf("  %-16s %9llu of %llu triangles kept (%.1f%%)\n", "", (unsigned long long)(kept / 3),
+           (unsigned long long)triangles, 100.0 * (double)(kept / 3) / (double)triangles);
+    printf("  %-16s %9u visible meshlets culled when stretched\n", "", wrong);
+    bench_report("cull", samples, MESHLET_RUNS);
+
+    free(samples);
+    free(out);
+    free(world);
+    mesh_data_unmap(&mesh);
+    return wrong > 0 ? 1 : 0;
+}
@@ -0,0 +1,105 @@
+// Software rasterizer throughput: a grid of textured pyramids, the same mesh
+// and texture the app draws, rendered on the CPU across the job system.
+// Setup covers transform, clipping and binning on the calling thread; shade
+// is the parallel per-tile pass.
+#include "bench.h"
+#include "job.h"
+#include "mesh.h"
+#include "raster.h"
+#include "sokol_time.h"
+#include "stb_image.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define RASTER_DEFAULT_GRID   32
+#define RASTER_WIDTH          640
+#define RASTER_HEIGHT         480
+#define RASTER_RUNS           50
+#define RASTER_SPACING        1.5f
+#define RASTER_CLEAR_COLOR    0xFF1A1A1Au  // the app's 0.1 grey
+
+// bench raster [grid] [workers]: grid x grid pyramids; workers as the app's
+// threads= option, 0 for one per core
+int bench_raster(int argc, char *argv[]) {
+    int grid    = argc > 0 ? atoi(argv[0]) : RASTER_DEFAULT_GRID;
+    int workers = argc > 1 ? atoi(argv[1]) : 0;
+    if (grid <= 0 || workers < 0) {
+        fprintf(stderr, "raster: grid must be positive\n");
+        return 1;
+    }
+    stm_setup();
+
+    MeshData mesh;
+    if (!mesh_data_map(&mesh, "data/meshes/pyramid.mesh")) {
+        fprintf(stderr, "raster: failed to load data/meshes/pyramid.mesh\n");
+        return 1;
+    }
+    int      tex_w, tex_h, channels;
+    stbi_uc *pixels = stbi_load("data/textures/obamna.png", &tex_w, &tex_h, &channels, 4);
+    if (!pixels) {
+        fprintf(stderr, "raster: failed to load data/textures/obamna.png\n");
+        mesh_data_unmap(&mesh);
+        return 1;
+    }
+    RasterTexture tex = { .texels = (const uint32_t *)pixels, .width = (uint32_t)tex_w, .height = (uint32_t)tex_h };
+
+    Raster raster;
+    if (!raster_init(&raster, RASTER_WIDTH, RASTER_HEIGHT)) {
+        fprintf(stderr, "raster: out of memory\n");
+        stbi_image_free(pixels);
+        mesh_data_unmap(&mesh);
+        return 1;
+    }
+    job_system_init((uint32_t)workers);
+
+    // Looking down the grid from above its near edge
+    float    extent    = (float)grid * RASTER_SPACING;
+    HMM_Mat4 proj      = HMM_Perspective_RH_NO(HMM_AngleDeg(60.0f), (float)RASTER_WIDTH / RASTER_HEIGHT, 0.1f,
+                                               extent * 2.0f);
+    HMM_Mat4 view      = HMM_LookAt_RH(HMM_V3(0.0f, extent * 0.3f, extent * 0.6f), HMM_V3(0.0f, 0.0f, 0.0f),
+                                       HMM_V3(0.0f, 1.0f, 0.0f));
+    HMM_Mat4 view_proj = HMM_MulM4(proj, view);
+
+    uint32_t count    = (uint32_t)(grid * grid);
+    double  *samples[3];
+    for (int s = 0; s < 3; s++) samples[s] = malloc(RASTER_RUNS * sizeof(double));
+
+    const MeshHeader *h = mesh.header;
+    for (int r = -1; r < RASTER_RUNS; r++) {
+        uint64_t start = stm_now();
+        raster_begin(&raster, RASTER_CLEAR_COLOR, 1.0f);
+        for (uint32_t i = 0; i < count; i++) {
+            float    x     = ((float)(i % (uint32_t)grid) - (float)grid * 0.5f) * RASTER_SPACING;
+            float    z     = ((float)(i / (uint32_t)grid) - (float)grid * 0.5f) * RASTER_SPACING;
+            HMM_Mat4 model = HMM_MulM4(HMM_Translate(HMM_V3(x, 0.0f, z)), HMM_Rotate_RH((float)i, HMM_V3(0.0f, 1.0f, 0.0f)));
+            raster_draw(&raster, mesh.vertices, h->vertex_count, mesh.indices, h->index_size, h->lods[0].index_count,
+                        HMM_MulM4(view_proj, model), &tex);
+        }
+        uint64_t setup = stm_now();
+        raster_end(&raster);
+        uint64_t end = stm_now();
+        if (r >= 0) {
+            samples[0][r] = stm_ms(stm_diff(setup, start));
+            samples[1][r] = stm_ms(stm_diff(end, setup));
+            samples[2][r] = stm_ms(stm_diff(end, start));
+        }
+    }
+
+    printf("  %u pyramids, %u triangles, %dx%d, %u threads\n", count, raster.stats.triangles, RASTER_WIDTH,
+           RASTER_HEIGHT, job_thread_count());
+    printf("  %-16s %9u rasterized  %9u tile entries\n", "", raster.stats.rasterized, raster.stats.bin_entries);
+    bench_report("setup", samples[0], RASTER_RUNS);
+    bench_report("shade", samples[1], RASTER_RUNS);
+    bench_report("frame", samples[2], RASTER_RUNS);
+    double p50 = samples[2][RASTER_RUNS / 2];
+    printf("  %-16s %9.2f Mtri/s  %9.2f Mpix/s\n", "", raster.stats.triangles / (p50 * 1e3),
+           (double)RASTER_WIDTH * RASTER_HEIGHT / (p50 * 1e3));
+
+    for (int s = 0; s < 3; s++) free(samples[s]);
+    job_system_shutdown();
+    raster_free(&raster);
+    stbi_image_free(pixels);
+    mesh_data_unmap(&mesh);
+    return 0;
+}
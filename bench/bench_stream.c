@@ -0,0 +1,67 @@
+// Streaming buffer throughput: a frame's worth of data written in chunks of
+// a given size (a debug line, a particle batch, a procedural mesh), then
+// flushed and committed the way a frame would.
+#include "bench.h"
+#include "stream.h"
+#include "sokol_gfx.h"
+#include "sokol_glue.h"
+#include "sokol_log.h"
+#include "sokol_time.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define STREAM_DEFAULT_MB 4
+#define STREAM_RUNS       100
+
+static const size_t chunk_sizes[] = { 32, 1024, 64 * 1024 };
+
+// bench stream [mb_per_frame]
+int bench_stream(int argc, char *argv[]) {
+    int mb = argc > 0 ? atoi(argv[0]) : STREAM_DEFAULT_MB;
+    if (mb <= 0) {
+        fprintf(stderr, "stream: size must be positive\n");
+        return 1;
+    }
+    size_t frame_bytes = (size_t)mb * 1024 * 1024;
+    stm_setup();
+    sg_setup(&(sg_desc){
+        .environment = sglue_environment(),
+        .logger.func = slog_func,
+    });
+
+    Stream stream;
+    if (!stream_init(&stream, frame_bytes, false, "bench-stream")) {
+        fprintf(stderr, "stream: out of memory\n");
+        sg_shutdown();
+        return 1;
+    }
+
+    double *samples = malloc(STREAM_RUNS * sizeof(double));
+    char    name[64];
+    printf("  %d MB per frame, %d frames, %s backend\n", mb, STREAM_RUNS,
+           sg_query_backend() == SG_BACKEND_DUMMY ? "dummy" : "gl");
+    for (size_t c = 0; c < sizeof(chunk_sizes) / sizeof(chunk_sizes[0]); c++) {
+        size_t chunk = chunk_sizes[c];
+        for (int r = -1; r < STREAM_RUNS; r++) {
+            uint64_t start = stm_now();
+            uint32_t offset;
+            void    *dst;
+            while ((dst = stream_alloc(&stream, chunk, &offset)) != NULL) memset(dst, r & 0xFF, chunk);
+            stream_flush(&stream);
+            sg_commit();
+            stream_next_frame(&stream);
+            if (r >= 0) samples[r] = stm_ms(stm_since(start));
+        }
+        snprintf(name, sizeof(name), "%zu B chunks", chunk);
+        bench_report(name, samples, STREAM_RUNS);
+        double p50 = samples[STREAM_RUNS / 2];
+        printf("  %-16s %9.2f MB/frame  %9.2f GB/s\n", "", (double)frame_bytes / (1024.0 * 1024.0),
+               (double)frame_bytes / (p50 * 1e-3) / 1e9);
+    }
+
+    free(samples);
+    stream_destroy(&stream);
+    sg_shutdown();
+    return 0;
+}
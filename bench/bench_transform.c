@@ -0,0 +1,111 @@
+// Batch transform kernels against the one-matrix-at-a-time HandmadeMath path
+// frame() used: TRS compose, and view-projection times world.
+#include "bench.h"
+#include "scene.h"
+#include "transform.h"
+#include "sokol_time.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define TRANSFORM_DEFAULT_COUNT 10000
+#define TRANSFORM_RUNS          200
+
+static float max_error(const HMM_Mat4 *a, const HMM_Mat4 *b, uint32_t count) {
+    float err = 0.0f;
+    for (uint32_t i = 0; i < count; i++) {
+        for (int e = 0; e < 16; e++) {
+            float d = fabsf(a[i].Elements[e / 4][e % 4] - b[i].Elements[e / 4][e % 4]);
+            if (d > err) err = d;
+        }
+    }
+    return err;
+}
+
+int bench_transform(int argc, char *argv[]) {
+    uint32_t count = argc > 0 ? (uint32_t)atoi(argv[0]) : TRANSFORM_DEFAULT_COUNT;
+    if (count == 0) {
+        fprintf(stderr, "transform: count must be positive\n");
+        return 1;
+    }
+    stm_setup();
+
+    Scene scene;
+    if (!scene_init(&scene, count)) {
+        fprintf(stderr, "transform: out of memory for %u entities\n", count);
+        return 1;
+    }
+    srand(1);
+    for (uint32_t i = 0; i < count; i++) {
+        HMM_Vec3 axis = HMM_NormV3(HMM_V3((float)rand() / RAND_MAX - 0.5f, (float)rand() / RAND_MAX + 0.1f, 0.3f));
+        HMM_Quat rot  = HMM_QFromAxisAngle_RH(axis, (float)rand() / RAND_MAX * HMM_PI);
+        float    s    = 0.5f + (float)rand() / RAND_MAX;
+        scene_add(&scene, HMM_V3((float)i, 0.0f, -(float)i), rot, HMM_V3(s, s, s), 0, 0);
+    }
+    TransformSoA in = {
+        .pos   = { scene.pos_x, scene.pos_y, scene.pos_z },
+        .rot   = { scene.rot_x, scene.rot_y, scene.rot_z, scene.rot_w },
+        .scale = { scene.scale_x, scene.scale_y, scene.scale_z },
+    };
+
+    HMM_Mat4 *reference = malloc(count * sizeof(HMM_Mat4));
+    HMM_Mat4 *world     = malloc(count * sizeof(HMM_Mat4));
+    HMM_Mat4 *mvp       = malloc(count * sizeof(HMM_Mat4));
+    double   *samples   = malloc(TRANSFORM_RUNS * sizeof(double));
+    HMM_Mat4  view_proj = HMM_MulM4(HMM_Perspective_RH_NO(HMM_PI / 4.0f, 4.0f / 3.0f, 0.1f, 100.0f),
+                                    HMM_LookAt_RH(HMM_V3(0, 1, 3), HMM_V3(0, 0, 0), HMM_V3(0, 1, 0)));
+    char      name[64];
+
+    printf("  %u transforms, %d runs, times per batch\n", count, TRANSFORM_RUNS);
+
+    // Baseline: HandmadeMath, one matrix at a time
+    for (int r = 0; r < TRANSFORM_RUNS; r++) {
+        uint64_t start = stm_now();
+        for (uint32_t i = 0; i < count; i++) {
+            HMM_Quat q = HMM_Q(in.rot[0][i], in.rot[1][i], in.rot[2][i], in.rot[3][i]);
+            reference[i] = HMM_MulM4(HMM_Translate(HMM_V3(in.pos[0][i], in.pos[1][i], in.pos[2][i])),
+                                     HMM_MulM4(HMM_QToM4(q),
+                                               HMM_Scale(HMM_V3(in.scale[0][i], in.scale[1][i], in.scale[2][i]))));
+        }
+        samples[r] = stm_ms(stm_since(start));
+    }
+    bench_report("compose hmm", samples, TRANSFORM_RUNS);
+
+    for (int b = 0; b < TRANSFORM_BACKEND_COUNT; b++) {
+        if (!transform_use((TransformBackend)b)) continue;
+        for (int r = 0; r < TRANSFORM_RUNS; r++) {
+            uint64_t start = stm_now();
+            transform_compose(&in, world, count);
+            samples[r] = stm_ms(stm_since(start));
+        }
+        snprintf(name, sizeof(name), "compose %s", transform_backend_name((TransformBackend)b));
+        bench_report(name, samples, TRANSFORM_RUNS);
+        printf("  %-16s max error %g\n", "", (double)max_error(world, reference, count));
+    }
+
+    for (int r = 0; r < TRANSFORM_RUNS; r++) {
+        uint64_t start = stm_now();
+        for (uint32_t i = 0; i < count; i++) reference[i] = HMM_MulM4(view_proj, world[i]);
+        samples[r] = stm_ms(stm_since(start));
+    }
+    bench_report("mvp hmm", samples, TRANSFORM_RUNS);
+
+    for (int b = 0; b < TRANSFORM_BACKEND_COUNT; b++) {
+        if (!transform_use((TransformBackend)b)) continue;
+        for (int r = 0; r < TRANSFORM_RUNS; r++) {
+            uint64_t start = stm_now();
+            transform_mul(view_proj, world, mvp, count);
+            samples[r] = stm_ms(stm_since(start));
+        }
+        snprintf(name, sizeof(name), "mvp %s", transform_backend_name((TransformBackend)b));
+        bench_report(name, samples, TRANSFORM_RUNS);
+        printf("  %-16s max error %g\n", "", (double)max_error(mvp, reference, count));
+    }
+
+    free(samples);
+    free(mvp);
+    free(world);
+    free(reference);
+    scene_free(&scene);
+    return 0;
+}
@@ -0,0 +1,64 @@
+// Stand-ins for the sokol_app and sokol_glue functions main.c calls. The
+// headless build has no window, so the harness plays the platform: a fixed
+// size swapchain and a fixed timestep keep runs reproducible.
+#include "bench.h"
+#include "sokol_app.h"
+#include "sokol_gfx.h"
+#include "sokol_glue.h"
+
+#define HEADLESS_WIDTH  640
+#define HEADLESS_HEIGHT 480
+#define HEADLESS_DT     (1.0 / 60.0)
+
+static bool quit_requested;
+
+int sapp_width(void) {
+    return HEADLESS_WIDTH;
+}
+
+int sapp_height(void) {
+    return HEADLESS_HEIGHT;
+}
+
+double sapp_frame_duration(void) {
+    return HEADLESS_DT;
+}
+
+void sapp_lock_mouse(bool lock) {
+    (void)lock;
+}
+
+void sapp_set_window_title(const char *title) {
+    (void)title;
+}
+
+// No loop to stop, so the harness checks after init() instead
+void sapp_quit(void) {
+    quit_requested = true;
+}
+
+bool headless_quit_requested(void) {
+    bool requested = quit_requested;
+    quit_requested = false;
+    return requested;
+}
+
+sg_environment sglue_environment(void) {
+    return (sg_environment){
+        .defaults = {
+            .color_format = SG_PIXELFORMAT_RGBA8,
+            .depth_format = SG_PIXELFORMAT_DEPTH_STENCIL,
+            .sample_count = 1,
+        },
+    };
+}
+
+sg_swapchain sglue_swapchain(void) {
+    return (sg_swapchain){
+        .width        = HEADLESS_WIDTH,
+        .height       = HEADLESS_HEIGHT,
+        .sample_count = 1,
+        .color_format = SG_PIXELFORMAT_RGBA8,
+        .depth_format = SG_PIXELFORMAT_DEPTH_STENCIL,
+    };
+}
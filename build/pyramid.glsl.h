@@ -0,0 +1,146 @@
+#pragma once
+/* local stand-in for sokol-shdc output (not committed) */
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <stddef.h>
+#if !defined(SOKOL_GFX_INCLUDED)
+#error "Please include sokol_gfx.h before pyramid.glsl.h"
+#endif
+#if !defined(SOKOL_SHDC_ALIGN)
+#define SOKOL_SHDC_ALIGN(a) __attribute__((aligned(a)))
+#endif
+#define ATTR_pyramid_position (0)
+#define ATTR_pyramid_texcoord (1)
+#define UB_vs_params (0)
+#define VIEW_tex (0)
+#define SMP_smp (0)
+#define ATTR_pyramid_instanced_position (0)
+#define ATTR_pyramid_instanced_texcoord (1)
+#define ATTR_pyramid_instanced_model0 (2)
+#define ATTR_pyramid_instanced_model1 (3)
+#define ATTR_pyramid_instanced_model2 (4)
+#define ATTR_pyramid_instanced_model3 (5)
+#define UB_vs_instanced_params (0)
+#define ATTR_pyramid_pulled_position (0)
+#define ATTR_pyramid_pulled_texcoord (1)
+#define ATTR_pyramid_pulled_object_index (2)
+#define VIEW_objects (1)
+#pragma pack(push,1)
+SOKOL_SHDC_ALIGN(16) typedef struct vs_params_t {
+    float mvp[16];
+} vs_params_t;
+SOKOL_SHDC_ALIGN(16) typedef struct vs_instanced_params_t {
+    float view_proj[16];
+} vs_instanced_params_t;
+SOKOL_SHDC_ALIGN(16) typedef struct object_params_t {
+    float mvp[16];
+} object_params_t;
+#pragma pack(pop)
+static inline const sg_shader_desc* pyramid_shader_desc(sg_backend backend) {
+    if (backend == SG_BACKEND_GLCORE) {
+        static sg_shader_desc desc;
+        static bool valid;
+        if (!valid) {
+            valid = true;
+            desc.vertex_func.source = "#version 430\n";
+            desc.vertex_func.entry = "main";
+            desc.fragment_func.source = "#version 430\n";
+            desc.fragment_func.entry = "main";
+            desc.attrs[0].base_type = SG_SHADERATTRBASETYPE_FLOAT;
+            desc.attrs[0].glsl_name = "position";
+            desc.attrs[1].base_type = SG_SHADERATTRBASETYPE_FLOAT;
+            desc.attrs[1].glsl_name = "texcoord";
+            desc.uniform_blocks[0].stage = SG_SHADERSTAGE_VERTEX;
+            desc.uniform_blocks[0].layout = SG_UNIFORMLAYOUT_STD140;
+            desc.uniform_blocks[0].size = 64;
+            desc.uniform_blocks[0].glsl_uniforms[0].type = SG_UNIFORMTYPE_FLOAT4;
+            desc.uniform_blocks[0].glsl_uniforms[0].array_count = 4;
+            desc.uniform_blocks[0].glsl_uniforms[0].glsl_name = "vs_params";
+            desc.views[0].texture.stage = SG_SHADERSTAGE_FRAGMENT;
+            desc.views[0].texture.image_type = SG_IMAGETYPE_2D;
+            desc.views[0].texture.sample_type = SG_IMAGESAMPLETYPE_FLOAT;
+            desc.samplers[0].stage = SG_SHADERSTAGE_FRAGMENT;
+            desc.samplers[0].sampler_type = SG_SAMPLERTYPE_FILTERING;
+            desc.texture_sampler_pairs[0].stage = SG_SHADERSTAGE_FRAGMENT;
+            desc.texture_sampler_pairs[0].view_slot = 0;
+            desc.texture_sampler_pairs[0].sampler_slot = 0;
+            desc.texture_sampler_pairs[0].glsl_name = "tex_smp";
+            desc.label = "pyramid_shader";
+        }
+        return &desc;
+    }
+    return 0;
+}
+
+static inline const sg_shader_desc* pyramid_instanced_shader_desc(sg_backend backend) {
+    if (backend == SG_BACKEND_GLCORE) {
+        static sg_shader_desc desc;
+        static bool valid;
+        if (!valid) {
+            valid = true;
+            desc.vertex_func.source = "#version 430\n";
+            desc.vertex_func.entry = "main";
+            desc.fragment_func.source = "#version 430\n";
+            desc.fragment_func.entry = "main";
+            desc.attrs[0].base_type = SG_SHADERATTRBASETYPE_FLOAT;
+            desc.attrs[0].glsl_name = "position";
+            desc.attrs[1].base_type = SG_SHADERATTRBASETYPE_FLOAT;
+            desc.attrs[1].glsl_name = "texcoord";
+            desc.uniform_blocks[0].stage = SG_SHADERSTAGE_VERTEX;
+            desc.uniform_blocks[0].layout = SG_UNIFORMLAYOUT_STD140;
+            desc.uniform_blocks[0].size = 64;
+            desc.uniform_blocks[0].glsl_uniforms[0].type = SG_UNIFORMTYPE_FLOAT4;
+            desc.uniform_blocks[0].glsl_uniforms[0].array_count = 4;
+            desc.uniform_blocks[0].glsl_uniforms[0].glsl_name = "vs_instanced_params";
+            desc.views[0].texture.stage = SG_SHADERSTAGE_FRAGMENT;
+            desc.views[0].texture.image_type = SG_IMAGETYPE_2D;
+            desc.views[0].texture.sample_type = SG_IMAGESAMPLETYPE_FLOAT;
+            desc.samplers[0].stage = SG_SHADERSTAGE_FRAGMENT;
+            desc.samplers[0].sampler_type = SG_SAMPLERTYPE_FILTERING;
+            desc.texture_sampler_pairs[0].stage = SG_SHADERSTAGE_FRAGMENT;
+            desc.texture_sampler_pairs[0].view_slot = 0;
+            desc.texture_sampler_pairs[0].sampler_slot = 0;
+            desc.texture_sampler_pairs[0].glsl_name = "tex_smp";
+            for (int a = 2; a < 6; a++) desc.attrs[a].base_type = SG_SHADERATTRBASETYPE_FLOAT;
+            desc.label = "pyramid_instanced_shader";
+        }
+        return &desc;
+    }
+    return 0;
+}
+
+static inline const sg_shader_desc* pyramid_pulled_shader_desc(sg_backend backend) {
+    if (backend == SG_BACKEND_GLCORE) {
+        static sg_shader_desc desc;
+        static bool valid;
+        if (!valid) {
+            valid = true;
+            desc.vertex_func.source = "#version 430\n";
+            desc.vertex_func.entry = "main";
+            desc.fragment_func.source = "#version 430\n";
+            desc.fragment_func.entry = "main";
+            desc.attrs[0].base_type = SG_SHADERATTRBASETYPE_FLOAT;
+            desc.attrs[0].glsl_name = "position";
+            desc.attrs[1].base_type = SG_SHADERATTRBASETYPE_FLOAT;
+            desc.attrs[1].glsl_name = "texcoord";
+            desc.attrs[2].base_type = SG_SHADERATTRBASETYPE_UINT;
+            desc.attrs[2].glsl_name = "object_index";
+            desc.views[0].texture.stage = SG_SHADERSTAGE_FRAGMENT;
+            desc.views[0].texture.image_type = SG_IMAGETYPE_2D;
+            desc.views[0].texture.sample_type = SG_IMAGESAMPLETYPE_FLOAT;
+            desc.views[1].storage_buffer.stage = SG_SHADERSTAGE_VERTEX;
+            desc.views[1].storage_buffer.readonly = true;
+            desc.views[1].storage_buffer.glsl_binding_n = 1;
+            desc.samplers[0].stage = SG_SHADERSTAGE_FRAGMENT;
+            desc.samplers[0].sampler_type = SG_SAMPLERTYPE_FILTERING;
+            desc.texture_sampler_pairs[0].stage = SG_SHADERSTAGE_FRAGMENT;
+            desc.texture_sampler_pairs[0].view_slot = 0;
+            desc.texture_sampler_pairs[0].sampler_slot = 0;
+            desc.texture_sampler_pairs[0].glsl_name = "tex_smp";
+            desc.label = "pyramid_pulled_shader";
+        }
+        return &desc;
+    }
+    return 0;
+}
@@ -14,6 +14,54 @@ void main() {
 }
 @end
 
+// Instanced variant: the model matrix comes from a per-instance vertex
+// buffer, one column per attribute, so only view-projection is uniform
+@vs vs_instanced
+layout(binding=0) uniform vs_instanced_params {
+    mat4 view_proj;
+};
+
+in vec3 position;
+in vec2 texcoord;
+in vec4 model0;
+in vec4 model1;
+in vec4 model2;
+in vec4 model3;
+
+out vec2 uv;
+
+void main() {
+    mat4 model = mat4(model0, model1, model2, model3);
+    gl_Position = view_proj * model * vec4(position, 1.0);
+    uv = texcoord;
+}
+@end
+
+// Pulled variant: every object's MVP is written once per frame into the
+// objects storage buffer. A draw selects its object with the base instance,
+// which arrives through the per-instance object_index attribute since GL's
+// gl_InstanceID doesn't include it.
+@vs vs_pulled
+struct object_params {
+    mat4 mvp;
+};
+
+layout(binding=1) readonly buffer objects {
+    object_params obj[];
+};
+
+in vec3 position;
+in vec2 texcoord;
+in uint object_index;
+
+out vec2 uv;
+
+void main() {
+    gl_Position = obj[object_index].mvp * vec4(position, 1.0);
+    uv = texcoord;
+}
+@end
+
 @fs fs
 layout(binding=0) uniform texture2D tex;
 layout(binding=0) uniform sampler smp;
@@ -28,3 +76,5 @@ void main() {
 @end
 
 @program pyramid vs fs
+@program pyramid_instanced vs_instanced fs
+@program pyramid_pulled vs_pulled fs
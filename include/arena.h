@@ -0,0 +1,63 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct ArenaBlock ArenaBlock;
+
+// Linear allocator: allocations bump a pointer and are all released at once
+// by arena_reset(). arena_alloc() is lock-free, so jobs can allocate from a
+// shared arena. Requests that don't fit are served from the heap until the
+// next reset, which then grows the arena to the peak seen, so a steady
+// workload stops touching the heap after its first frames.
+typedef struct {
+    uint8_t        *base;
+    size_t          capacity;
+    atomic_size_t   used;
+
+    ArenaBlock     *overflow;       // heap blocks, freed by arena_reset()
+    atomic_size_t   overflow_size;
+    pthread_mutex_t overflow_lock;
+} Arena;
+
+void   arena_init(Arena *arena, size_t capacity);
+void   arena_free(Arena *arena);
+
+// size bytes aligned to align (a power of two). Never returns NULL unless
+// the heap is exhausted.
+void  *arena_alloc(Arena *arena, size_t size, size_t align);
+
+// Typed helper: room for count objects of type
+#define arena_push(arena, type, count) \
+    ((type *)arena_alloc((arena), sizeof(type) * (size_t)(count), _Alignof(type)))
+
+// Release every allocation. Not thread-safe; nothing may still be using the
+// arena's memory.
+void   arena_reset(Arena *arena);
+
+// Bytes handed out since the last reset, including overflow
+size_t arena_used(Arena *arena);
+
+// Two arenas used on alternate frames. Data allocated in one frame stays
+// valid through the next, so work handed to threads that finishes a frame
+// late never reads freed memory.
+typedef struct {
+    Arena    arenas[2];
+    uint32_t current;
+} FrameArena;
+
+void   frame_arena_init(FrameArena *fa, size_t capacity);
+void   frame_arena_free(FrameArena *fa);
+
+// This frame's arena, and last frame's (still intact)
+Arena *frame_arena_current(FrameArena *fa);
+Arena *frame_arena_previous(FrameArena *fa);
+
+// End the frame: the current arena becomes previous and the older one is
+// reset for reuse. Call once at the end of frame().
+void   frame_arena_swap(FrameArena *fa);
+
+#endif // ARENA_H
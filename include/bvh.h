@@ -0,0 +1,91 @@
+#ifndef BVH_H
+#define BVH_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "HandmadeMath.h"
+#include "frustum.h"
+#include "scene.h"
+
+// Most entities a leaf is split down to
+#define BVH_LEAF_SIZE 4
+
+// Parent of the root
+#define BVH_INVALID UINT32_MAX
+
+// Deepest the tree is allowed to grow; bounds the traversal stacks
+#define BVH_MAX_DEPTH 64
+
+typedef struct {
+    float    min[3];
+    float    max[3];
+    // Internal node: index of the left child, the right child follows it.
+    // Leaf: index of the first entity in Bvh.items.
+    uint32_t first;
+    uint32_t count;    // entities in a leaf, 0 for internal nodes
+} BvhNode;
+
+// Bounding volume hierarchy over the scene's world bounding spheres. Nodes
+// are stored depth-first, so every child comes after its parent.
+typedef struct {
+    BvhNode  *nodes;
+    uint32_t *parent;      // per node, BVH_INVALID for the root
+    uint32_t  node_count;
+    uint32_t *items;       // entity indices, grouped by leaf
+    uint32_t *leaf;        // per entity, the leaf holding it
+    uint32_t  item_count;
+    uint32_t  capacity;    // entities
+} Bvh;
+
+// A subtree and the range of Bvh.items it holds
+typedef struct {
+    uint32_t node;
+    uint32_t first;
+    uint32_t count;
+} BvhSubtree;
+
+typedef struct {
+    uint32_t entity;
+    float    t;            // distance along the ray
+} BvhHit;
+
+// Allocate storage for a tree over up to capacity entities
+void     bvh_init(Bvh *bvh, uint32_t capacity);
+void     bvh_free(Bvh *bvh);
+
+// Build the tree from scratch over the scene's world spheres (binned SAH).
+// Needed after entities are added or removed, since those change indices.
+void     bvh_build(Bvh *bvh, const Scene *scene);
+
+// Recompute node bounds bottom-up after entities moved, keeping the tree
+// shape. The tree degrades if entities travel far; rebuild then.
+void     bvh_refit(Bvh *bvh, const Scene *scene);
+
+// Incremental refit: only update the leaves holding the given entities and
+// the nodes above them whose bounds actually change. moved is as written by
+// scene_update_transforms().
+void     bvh_refit_moved(Bvh *bvh, const Scene *scene, const uint32_t *moved, uint32_t count);
+
+// Write the entities whose spheres intersect the frustum to visible. Order
+// follows the tree, not entity index. Returns the number written.
+uint32_t bvh_cull_frustum(const Bvh *bvh, const Scene *scene, const Frustum *f, uint32_t *visible);
+
+// Cut the tree into at most max disjoint subtrees that together hold every
+// entity, splitting the largest first, so a traversal can be spread over
+// jobs. Written in items order. Returns the number written.
+uint32_t bvh_split(const Bvh *bvh, BvhSubtree *out, uint32_t max);
+
+// bvh_cull_frustum() over one subtree. visible needs room for its count.
+uint32_t bvh_cull_frustum_subtree(const Bvh *bvh, const Scene *scene, const Frustum *f, uint32_t root,
+                                  uint32_t *visible);
+
+// Closest entity sphere hit by the ray within max_t. dir must be unit length.
+bool     bvh_raycast(const Bvh *bvh, const Scene *scene, HMM_Vec3 origin, HMM_Vec3 dir, float max_t,
+                     BvhHit *hit);
+
+// Write up to max_out entities whose spheres overlap the query sphere.
+// Returns the number written.
+uint32_t bvh_query_radius(const Bvh *bvh, const Scene *scene, HMM_Vec3 center, float radius,
+                          uint32_t *out, uint32_t max_out);
+
+#endif // BVH_H
@@ -30,6 +30,9 @@ typedef struct {
 // Initialize a camera with sane defaults at the given position
 void     camera_init(Camera *cam, HMM_Vec3 position, float yaw);
 
+// Unit view direction from yaw and pitch
+HMM_Vec3 camera_forward(const Camera *cam);
+
 // Build the view matrix from camera state
 HMM_Mat4 camera_view(const Camera *cam);
 
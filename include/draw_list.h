@@ -0,0 +1,106 @@
+#ifndef DRAW_LIST_H
+#define DRAW_LIST_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "sokol_gfx.h"
+#include "arena.h"
+
+// Uniform blocks are copied into the list at this alignment
+#define DRAW_UNIFORM_ALIGN 16
+
+// Sort key layout, most significant first: pass, pipeline, material, depth.
+// Sorting groups draws by the state that is most expensive to change, then
+// front to back within a group.
+#define DRAW_KEY_PASS_BITS      4
+#define DRAW_KEY_PIPELINE_BITS  16
+#define DRAW_KEY_MATERIAL_BITS  16
+#define DRAW_KEY_DEPTH_BITS     28
+#define DRAW_KEY_DEPTH_SHIFT    0
+#define DRAW_KEY_MATERIAL_SHIFT (DRAW_KEY_DEPTH_SHIFT + DRAW_KEY_DEPTH_BITS)
+#define DRAW_KEY_PIPELINE_SHIFT (DRAW_KEY_MATERIAL_SHIFT + DRAW_KEY_MATERIAL_BITS)
+#define DRAW_KEY_PASS_SHIFT     (DRAW_KEY_PIPELINE_SHIFT + DRAW_KEY_PIPELINE_BITS)
+
+// One recorded draw. Commands are recorded on any thread and replayed on
+// the main thread by draw_lists_submit(), in sort_key order.
+typedef struct {
+    uint64_t           sort_key;
+    sg_pipeline        pipeline;
+    const sg_bindings *bindings;       // must stay valid until submit
+    int                uniform_slot;
+    uint32_t           uniform_offset; // into the recording list's uniform blob
+    uint32_t           uniform_size;   // 0 for none
+    int                base_element;
+    int                num_elements;
+    int                num_instances;
+    int                base_instance;  // needs sg_features.draw_base_instance if > 0
+} DrawCmd;
+
+// Commands and uniform data recorded by one thread. Storage comes from the
+// frame arena given to draw_lists_reset(); capacities carry over between
+// frames so a steady scene allocates each buffer once per frame.
+typedef struct {
+    Arena    *arena;
+    DrawCmd  *cmds;
+    uint32_t  count;
+    uint32_t  capacity;
+    uint8_t  *uniforms;
+    uint32_t  uniform_size;
+    uint32_t  uniform_capacity;
+} DrawList;
+
+// Replay order entry: a command's key and where it was recorded
+typedef struct {
+    uint64_t key;
+    uint32_t list;
+    uint32_t index;
+} DrawRef;
+
+// What the last draw_lists_submit() issued and skipped
+typedef struct {
+    uint32_t draws;
+    uint32_t pipelines;         // sg_apply_pipeline() calls
+    uint32_t pipelines_elided;  // skipped, same pipeline as the previous draw
+    uint32_t bindings;          // sg_apply_bindings() calls
+    uint32_t bindings_elided;
+    uint32_t triangles;         // assuming triangle lists
+} DrawStats;
+
+// One DrawList per job system thread
+typedef struct {
+    DrawList *lists;
+    uint32_t  list_count;
+    Arena    *arena;
+    DrawStats stats;
+} DrawLists;
+
+// Build a sort key. pipeline uses its sokol slot index, so keys stay stable
+// for the pipeline's lifetime. depth is view distance; negative depths
+// clamp to 0. Opaque draws sort front to back.
+uint64_t draw_key(uint32_t pass, sg_pipeline pipeline, uint32_t material, float depth);
+
+// One list per thread, each starting with room for cmds_per_thread commands
+// and uniform_bytes_per_thread bytes of uniforms; lists grow as needed
+void     draw_lists_init(DrawLists *dl, uint32_t thread_count, uint32_t cmds_per_thread,
+                         uint32_t uniform_bytes_per_thread);
+void     draw_lists_free(DrawLists *dl);
+
+// Empty every list and take fresh storage from arena, which must outlive
+// the next draw_lists_submit(). Call once per frame before recording.
+void     draw_lists_reset(DrawLists *dl, Arena *arena);
+
+// The calling thread's list (job_thread_index()); lists[0] for threads
+// outside the job system
+DrawList *draw_lists_local(DrawLists *dl);
+
+// Append cmd, copying size bytes of uniforms (may be 0) into the list.
+// cmd's uniform_offset and uniform_size are filled in here.
+void     draw_list_add(DrawList *list, const DrawCmd *cmd, const void *uniforms, uint32_t size);
+
+// Merge all lists, radix sort by key (ties keep thread and record order)
+// and issue the sg_* calls, skipping redundant pipeline and binding changes.
+// Call inside a pass, on the thread that owns sokol_gfx. Returns the number
+// of draws issued; DrawLists.stats has the detail.
+uint32_t draw_lists_submit(DrawLists *dl);
+
+#endif // DRAW_LIST_H
@@ -0,0 +1,72 @@
+#ifndef FRAME_TIMING_H
+#define FRAME_TIMING_H
+
+#include <stdint.h>
+
+// CPU phases of frame(), in the order they run
+typedef enum {
+    FRAME_PHASE_UPDATE,   // input and camera
+    FRAME_PHASE_BUILD,    // view, projection and model matrices
+    FRAME_PHASE_CULL,     // visibility and visible-list compaction
+    FRAME_PHASE_RECORD,   // draw commands into per-thread draw lists
+    FRAME_PHASE_SUBMIT,   // sg_* command submission up to sg_commit()
+    FRAME_PHASE_COUNT,
+} FramePhase;
+
+// Per-frame event counts reported alongside the timings
+typedef enum {
+    FRAME_COUNTER_DRAWS,
+    FRAME_COUNTER_PIPELINES,          // sg_apply_pipeline() calls
+    FRAME_COUNTER_PIPELINES_ELIDED,   // redundant ones skipped
+    FRAME_COUNTER_BINDINGS,           // sg_apply_bindings() calls
+    FRAME_COUNTER_BINDINGS_ELIDED,
+    FRAME_COUNTER_OCCLUDED,           // in the frustum but hidden by occluders
+    FRAME_COUNTER_TRIANGLES,          // drawn, after LOD selection
+    FRAME_COUNTER_MESHLETS_CULLED,    // dropped before drawing (meshlets=on)
+    FRAME_COUNTER_COUNT,
+} FrameCounter;
+
+// Render passes timed on the GPU
+typedef enum {
+    FRAME_GPU_MAIN,       // the swapchain pass
+    FRAME_GPU_COUNT,
+} FrameGpuPass;
+
+typedef struct {
+    // sokol_time ticks spent in each phase, and in the whole frame
+    uint64_t phase[FRAME_PHASE_COUNT];
+    uint64_t total;
+    uint32_t counters[FRAME_COUNTER_COUNT];
+
+    // GPU nanoseconds per pass, from the latest frame the GPU has finished
+    // (a few frames behind the CPU timings); 0 where unavailable
+    uint64_t gpu[FRAME_GPU_COUNT];
+} FrameTiming;
+
+// Mark the start of engine startup; the first frame_timing_end() after this
+// records the time to first frame. Call at the top of init(), after stm_setup().
+void frame_timing_startup(void);
+
+// Start timing a frame. stm_setup() must have been called.
+void frame_timing_begin(void);
+
+// Close the phase running since the previous begin/end_phase call
+void frame_timing_end_phase(FramePhase phase);
+
+// Add value to a counter of the current frame
+void frame_timing_count(FrameCounter counter, uint32_t value);
+
+// Set a pass's GPU time for the current frame's report
+void frame_timing_gpu(FrameGpuPass pass, uint64_t ns);
+
+// Finish the frame and publish its timings
+void frame_timing_end(void);
+
+// Timings of the most recently finished frame
+const FrameTiming *frame_timing_last(void);
+
+// Ticks from frame_timing_startup() to the end of the first frame, or 0 if
+// no frame has finished yet
+uint64_t frame_timing_first_frame(void);
+
+#endif // FRAME_TIMING_H
@@ -0,0 +1,54 @@
+#ifndef FRUSTUM_H
+#define FRUSTUM_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "HandmadeMath.h"
+
+typedef enum {
+    FRUSTUM_LEFT,
+    FRUSTUM_RIGHT,
+    FRUSTUM_BOTTOM,
+    FRUSTUM_TOP,
+    FRUSTUM_NEAR,
+    FRUSTUM_FAR,
+    FRUSTUM_PLANE_COUNT,
+} FrustumPlane;
+
+// Result of frustum_classify_aabb()
+typedef enum {
+    FRUSTUM_OUTSIDE,
+    FRUSTUM_INTERSECTS,
+    FRUSTUM_INSIDE,
+} FrustumClass;
+
+typedef struct {
+    // Normalized planes (xyz = inward normal, w = distance); a point p is
+    // inside a plane when dot(xyz, p) + w >= 0
+    HMM_Vec4 planes[FRUSTUM_PLANE_COUNT];
+} Frustum;
+
+// Extract the planes of a view-projection matrix with -1..1 clip depth, as
+// built by camera_projection()
+Frustum  frustum_from_matrix(HMM_Mat4 view_proj);
+
+// True if the volume is at least partly inside
+bool     frustum_test_sphere(const Frustum *f, HMM_Vec3 center, float radius);
+
+// True if the sphere is entirely inside, so nothing within it needs testing
+bool     frustum_contains_sphere(const Frustum *f, HMM_Vec3 center, float radius);
+bool     frustum_test_aabb(const Frustum *f, HMM_Vec3 min, HMM_Vec3 max);
+
+// Like frustum_test_aabb(), but also tells a box fully inside every plane
+// apart from one straddling a plane. Lets hierarchical culling accept a whole
+// subtree without testing its contents.
+FrustumClass frustum_classify_aabb(const Frustum *f, HMM_Vec3 min, HMM_Vec3 max);
+
+// Test count spheres given as separate x/y/z/radius arrays and write the
+// indices of those at least partly inside to visible, in order. Returns the
+// number written. Vectorized four spheres at a time.
+uint32_t frustum_cull_spheres(const Frustum *f,
+                              const float *x, const float *y, const float *z, const float *radius,
+                              uint32_t count, uint32_t *visible);
+
+#endif // FRUSTUM_H
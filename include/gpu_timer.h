@@ -0,0 +1,34 @@
+#ifndef GPU_TIMER_H
+#define GPU_TIMER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Timed passes per frame
+#define GPU_TIMER_MAX_PASSES 8
+
+// Frames of queries in flight. Results are read back this many frames late
+// at most, and never waited for.
+#define GPU_TIMER_FRAMES 4
+
+// GPU time per render pass from GL timestamp queries (SOKOL_GLCORE builds).
+// Elsewhere, and on GL contexts without timer queries, every call is a no-op
+// and results stay 0.
+
+// Call after sg_setup(). Returns whether GPU timing is available.
+bool     gpu_timer_setup(void);
+void     gpu_timer_shutdown(void);
+
+// Bracket a pass: begin right before sg_begin_pass(), end right after
+// sg_end_pass()
+void     gpu_timer_begin(uint32_t pass);
+void     gpu_timer_end(uint32_t pass);
+
+// Call once per frame after sg_commit(). Polls older frames' queries and
+// returns true if a newer result became available.
+bool     gpu_timer_end_frame(void);
+
+// GPU nanoseconds pass took in the most recent frame read back, 0 if none
+uint64_t gpu_timer_result(uint32_t pass);
+
+#endif // GPU_TIMER_H
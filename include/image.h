@@ -0,0 +1,24 @@
+#ifndef IMAGE_H
+#define IMAGE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// RGBA8 images as written by the renderers: R in the lowest byte, rows
+// stride pixels apart
+
+// Write a PNG (8-bit RGBA, deflate with fixed Huffman codes). Returns false
+// if the file can't be written or memory runs out.
+bool image_write_png(const char *path, const uint32_t *pixels, uint32_t width, uint32_t height,
+                     uint32_t stride);
+
+typedef struct {
+    uint32_t max_delta;   // largest per-channel difference
+    uint32_t differing;   // pixels with any channel differing by more than the tolerance
+} ImageDiff;
+
+// Compare two equally sized images channel by channel
+ImageDiff image_compare(const uint32_t *a, uint32_t a_stride, const uint32_t *b, uint32_t b_stride,
+                        uint32_t width, uint32_t height, uint32_t tolerance);
+
+#endif // IMAGE_H
@@ -0,0 +1,53 @@
+#ifndef JOB_H
+#define JOB_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+// Most worker threads job_system_init() will start
+#define JOB_MAX_WORKERS 63
+
+// Jobs each thread's deque can hold; pushes past this run inline
+#define JOB_DEQUE_SIZE 4096
+
+typedef void (*JobFunc)(void *data);
+
+// Called with a sub-range [begin, end) of a job_parallel_for()
+typedef void (*JobRangeFunc)(void *data, uint32_t begin, uint32_t end);
+
+// Counts unfinished jobs. A job can depend on others by waiting on their
+// counter; zero-initialize before first use.
+typedef struct {
+    atomic_uint pending;
+} JobCounter;
+
+// Start worker_count worker threads, each with its own work-stealing deque.
+// 0 picks one per core minus the calling thread, which becomes thread 0 and
+// runs jobs while it waits.
+bool     job_system_init(uint32_t worker_count);
+
+// Finish queued jobs and join the workers
+void     job_system_shutdown(void);
+
+// Worker threads plus the thread that called job_system_init()
+uint32_t job_thread_count(void);
+
+// Index of the calling thread in [0, job_thread_count()), or UINT32_MAX for
+// threads the job system doesn't know
+uint32_t job_thread_index(void);
+
+// Queue func(data) on the calling thread's deque. counter, if not NULL, is
+// incremented now and decremented when the job finishes. Runs the job
+// immediately when called from outside the job system or the deque is full.
+void     job_run(JobFunc func, void *data, JobCounter *counter);
+
+// Run other jobs until counter reaches zero
+void     job_wait(JobCounter *counter);
+
+// Split [0, count) into ranges of grain items, aligned to multiples of grain
+// (so begin / grain is a stable chunk index), run them across all threads
+// and wait for them.
+void     job_parallel_for(uint32_t count, uint32_t grain, JobRangeFunc func, void *data);
+
+#endif // JOB_H
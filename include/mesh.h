@@ -0,0 +1,64 @@
+#ifndef MESH_H
+#define MESH_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "HandmadeMath.h"
+#include "mesh_format.h"
+#include "sokol_gfx.h"
+
+// A .mesh file mapped for CPU access, e.g. by the software rasterizer.
+// Pointers are into the mapping and stay valid until mesh_data_unmap().
+typedef struct {
+    void             *map;
+    size_t            map_size;
+    const MeshHeader *header;
+    const MeshVertex *vertices;
+    const void       *indices;   // header->index_size bytes each
+    const Meshlet    *meshlets;
+} MeshData;
+
+// A coarser LOD is only picked once its error is this fraction of the
+// threshold, so objects near a switching distance don't flicker between two
+#define MESH_LOD_HYSTERESIS 0.75f
+
+typedef struct {
+    sg_buffer     vertex_buffer;
+    sg_buffer     index_buffer;
+    sg_index_type index_type;
+    int           vertex_count;
+    int           index_count;   // LOD 0's
+
+    // Object-space bounds
+    HMM_Vec3      bounds_min;
+    HMM_Vec3      bounds_max;
+    HMM_Vec3      sphere_center;
+    float         sphere_radius;
+
+    // Levels of detail, runs of the index buffer. lods[0] is the full mesh.
+    uint32_t      lod_count;
+    MeshLod       lods[MESH_MAX_LODS];
+
+    // The file stays mapped, so meshlet culling can read the meshlets and
+    // copy index runs on the CPU
+    MeshData      data;
+} Mesh;
+
+// Map a .mesh file (see mesh_format.h) and upload its vertex and index
+// buffers. Call after sg_setup(). Leaves mesh zeroed on failure.
+bool mesh_load(Mesh *mesh, const char *path);
+
+void mesh_destroy(Mesh *mesh);
+
+// The coarsest LOD whose error, scaled by pixels_per_unit (screen pixels per
+// model unit at the object's distance), stays within threshold pixels.
+// Starts from the object's current LOD: it refines as soon as that is over
+// the threshold, but only coarsens below MESH_LOD_HYSTERESIS of it.
+uint32_t mesh_select_lod(const Mesh *mesh, uint32_t current, float pixels_per_unit, float threshold);
+
+// Map and validate a .mesh file. Leaves data zeroed on failure.
+bool mesh_data_map(MeshData *data, const char *path);
+void mesh_data_unmap(MeshData *data);
+
+#endif // MESH_H
@@ -0,0 +1,78 @@
+#ifndef MESH_FORMAT_H
+#define MESH_FORMAT_H
+
+#include <stdint.h>
+
+// On-disk layout of a mesh (.mesh), memory-mapped by mesh_load(). A header,
+// then interleaved vertices, then a 16- or 32-bit index buffer, then the
+// meshlet table, each section starting on a MESH_ALIGN boundary.
+#define MESH_MAGIC   0x48534D33u  // "3MSH"
+#define MESH_VERSION 3
+#define MESH_ALIGN   16
+
+// Levels of detail a mesh can carry, LOD 0 (full detail) included
+#define MESH_MAX_LODS 8
+
+// Meshlet size limits: few enough vertices to stay in the post-transform
+// cache, and triangles to keep culling fine-grained
+#define MESHLET_MAX_VERTICES  64
+#define MESHLET_MAX_TRIANGLES 124
+
+// Interleaved vertex, matching ATTR_pyramid_position / ATTR_pyramid_texcoord
+typedef struct {
+    float position[3];
+    float uv[2];
+} MeshVertex;
+
+// A cluster of neighbouring triangles: a run of the index buffer with its
+// bounding sphere and the cone its facing directions lie in. Seen from p,
+// the whole meshlet faces away if
+//   dot(center - p, cone_axis) >= cone_cutoff * length(center - p) + radius
+// cone_cutoff is 1 where the normals spread too far for that to happen.
+typedef struct {
+    uint32_t first_index;
+    uint32_t index_count;
+    float    center[3];
+    float    radius;
+    float    cone_axis[3];
+    float    cone_cutoff;
+} Meshlet;
+
+// One level of detail: a run of the shared index buffer over the shared
+// vertices, split into meshlets, and how far (model units) its surface may
+// stray from LOD 0
+typedef struct {
+    uint32_t first_index;
+    uint32_t index_count;
+    uint32_t first_meshlet;
+    uint32_t meshlet_count;
+    float    error;
+} MeshLod;
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+
+    uint32_t vertex_count;
+    uint32_t vertex_stride;   // sizeof(MeshVertex)
+    uint32_t vertex_offset;   // from the start of the file
+
+    uint32_t index_count;     // triangle lists of every LOD, 3 per triangle
+    uint32_t index_size;      // 2 or 4 bytes
+    uint32_t index_offset;
+
+    uint32_t meshlet_count;   // of every LOD, in LOD order
+    uint32_t meshlet_offset;
+
+    // Object-space bounds
+    float    bounds_min[3];
+    float    bounds_max[3];
+    float    sphere_center[3];
+    float    sphere_radius;
+
+    // Coarser levels follow LOD 0 in the index buffer, error increasing
+    uint32_t lod_count;
+    MeshLod  lods[MESH_MAX_LODS];
+} MeshHeader;
+
+#endif // MESH_FORMAT_H
@@ -0,0 +1,52 @@
+#ifndef MESHLET_H
+#define MESHLET_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "HandmadeMath.h"
+#include "frustum.h"
+#include "mesh.h"
+
+// CPU meshlet culling. Before an object is drawn, its meshlets outside the
+// frustum or facing away from the eye are dropped and the index runs of the
+// rest are copied out, to be streamed into an index buffer and drawn in one
+// call. Unlike back-face culling on the GPU, rejected triangles are never
+// sent at all.
+
+// Share of a LOD's indices culling has to drop before the rest are worth
+// copying out. Below it the LOD draws whole: the GPU rejects back faces
+// cheaply, while copying costs a pass over nearly every index.
+#define MESHLET_MIN_CULLED 0.25f
+
+// Returned by meshlet_cull() when the LOD should draw whole
+#define MESHLET_CULL_NONE UINT32_MAX
+
+// The frustum and eye in one object's model space, so meshlet bounds are
+// tested as stored. A caller that knows the whole object is inside the
+// frustum sets inside, leaving only the cone test.
+typedef struct {
+    Frustum  frustum;
+    HMM_Vec3 eye;
+    bool     inside;
+} MeshletView;
+
+// True if every LOD of data is split into meshlets, so culling can stand in
+// for its plain index ranges
+bool        meshlet_covers(const MeshData *data);
+
+// Bring a world-space frustum and eye into the model space of an object
+// drawn with world, which may rotate, translate and scale, also unevenly
+MeshletView meshlet_view(const Frustum *frustum, HMM_Vec3 eye, HMM_Mat4 world);
+
+// False if the meshlet is outside the frustum or all its triangles face away
+bool        meshlet_visible(const MeshletView *view, const Meshlet *meshlet);
+
+// Cull the meshlets of one LOD of data and copy the index runs of those left
+// to out, in data's index size; out needs room for the LOD's index count.
+// Returns the number of indices written and adds the meshlets dropped to
+// *culled. If they would drop less than MESHLET_MIN_CULLED of the indices,
+// nothing is copied or counted and MESHLET_CULL_NONE is returned, so the
+// caller draws the LOD's own index range instead.
+uint32_t    meshlet_cull(const MeshData *data, uint32_t lod, const MeshletView *view, void *out, uint32_t *culled);
+
+#endif // MESHLET_H
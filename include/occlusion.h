@@ -0,0 +1,60 @@
+#ifndef OCCLUSION_H
+#define OCCLUSION_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "HandmadeMath.h"
+#include "mesh_format.h"
+
+// Depth pyramid levels kept, level 0 included
+#define OCCLUSION_MAX_LEVELS 12
+
+// Rows of the depth buffer rasterized per job
+#define OCCLUSION_BAND_ROWS 16
+
+typedef struct OcclusionTri OcclusionTri;
+
+// Hierarchical-Z occlusion culling on the CPU. Designated occluder meshes are
+// rasterized into a low-resolution depth buffer (window z, 0 near), from
+// which a pyramid of min and max depth is built. Bounds are then tested
+// against it: an object whose nearest point lies behind the farthest
+// occluder depth over its screen rectangle is hidden.
+//
+// Depth is sampled at pixel centres, so an occluder's silhouette can hide
+// up to half a low-resolution pixel it doesn't quite cover. Occluder
+// triangles crossing the near plane are dropped, which only hides less.
+typedef struct {
+    uint32_t      width;    // a multiple of 4
+    uint32_t      height;
+    uint32_t      level_count;
+    uint32_t      level_width[OCCLUSION_MAX_LEVELS];
+    uint32_t      level_height[OCCLUSION_MAX_LEVELS];
+    float        *min_depth[OCCLUSION_MAX_LEVELS];   // level 0 is the depth buffer
+    float        *max_depth[OCCLUSION_MAX_LEVELS];   // level 0 shares min_depth[0]
+
+    HMM_Mat4      view_proj;
+    OcclusionTri *tris;
+    uint32_t      tri_count;
+    uint32_t      tri_capacity;
+} Occlusion;
+
+bool occlusion_init(Occlusion *o, uint32_t width, uint32_t height);
+void occlusion_free(Occlusion *o);
+
+// Start a frame seen through view_proj: drops last frame's occluders
+void occlusion_begin(Occlusion *o, HMM_Mat4 view_proj);
+
+// Queue a mesh's front faces (CCW) as an occluder. Returns false if out of
+// memory; the occluder is then partly missing, which only hides less.
+bool occlusion_add_occluder(Occlusion *o, const MeshVertex *vertices, uint32_t vertex_count,
+                            const void *indices, uint32_t index_size, uint32_t index_count, HMM_Mat4 world);
+
+// Rasterize the queued occluders across the job system and build the
+// pyramid. Call before testing.
+void occlusion_end(Occlusion *o);
+
+// False if the world-space box is certainly hidden behind the occluders.
+// Read-only, so any number of threads may test at once.
+bool occlusion_test_box(const Occlusion *o, HMM_Vec3 min, HMM_Vec3 max);
+
+#endif // OCCLUSION_H
@@ -0,0 +1,55 @@
+#ifndef POOL_H
+#define POOL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Handles pack a slot index in the low bits and the slot's generation in the
+// rest, like sokol_gfx's resource ids. Releasing a slot bumps its generation,
+// so old handles to it stop resolving. 0 is never a valid handle.
+#define POOL_INDEX_BITS   20
+#define POOL_INDEX_MASK   ((1u << POOL_INDEX_BITS) - 1)
+#define POOL_MAX_CAPACITY POOL_INDEX_MASK   // slot 0 is reserved
+#define POOL_INVALID      0
+
+// Fixed-capacity pool of item_size byte items. Live items are packed in
+// [0, count) for iteration; releasing one moves the last item into its
+// place, so item addresses are only stable until the next release.
+// item_size may be 0 when the owner keeps its own packed arrays and only
+// needs the handles (see Scene).
+typedef struct {
+    uint8_t  *items;
+    uint32_t *handles;      // handle of each packed item
+    uint32_t *dense;        // per slot: packed index of its item
+    uint32_t *generation;   // per slot
+    uint32_t *free_slots;   // stack of unused slots
+    uint32_t  free_count;
+    uint32_t  count;
+    uint32_t  capacity;
+    uint32_t  item_size;
+} Pool;
+
+// Returns false if capacity is over POOL_MAX_CAPACITY or out of memory
+bool     pool_init(Pool *pool, uint32_t capacity, uint32_t item_size);
+void     pool_free(Pool *pool);
+
+// Appends a zeroed item at packed index count - 1. Returns its handle, or
+// POOL_INVALID when full. O(1).
+uint32_t pool_alloc(Pool *pool);
+
+// Swap-remove handle's item. False if the handle is stale. O(1).
+bool     pool_release(Pool *pool, uint32_t handle);
+
+// Packed index of handle's item, or UINT32_MAX if the handle is stale
+uint32_t pool_index(const Pool *pool, uint32_t handle);
+
+// handle's item, or NULL if the handle is stale
+void    *pool_get(const Pool *pool, uint32_t handle);
+
+// Item at packed index, for iterating [0, count)
+static inline void *pool_at(const Pool *pool, uint32_t index) {
+    return pool->items + (size_t)index * pool->item_size;
+}
+
+#endif // POOL_H
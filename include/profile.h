@@ -0,0 +1,51 @@
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Threads that can record at once; later threads are ignored until one
+// releases its ring
+#define PROFILE_MAX_THREADS 64
+
+// Events kept per thread, oldest overwritten first. Power of two.
+#define PROFILE_RING_SIZE 8192
+
+// Open scopes per thread
+#define PROFILE_MAX_DEPTH 32
+
+// A finished scope, in sokol_time ticks
+typedef struct {
+    const char *name;
+    uint64_t    start;
+    uint64_t    end;
+} ProfileEvent;
+
+// Scopes nest: profile_end() closes the innermost open profile_begin() on
+// the calling thread. Each thread writes its own ring buffer, so recording
+// takes no locks; a thread's first event allocates its ring. name must
+// outlive the ring (use string literals). stm_setup() must have been called.
+void profile_begin(const char *name);
+void profile_end(void);
+
+// Record a span timed elsewhere
+void profile_record(const char *name, uint64_t start, uint64_t end);
+
+// Label the calling thread in exported traces
+void profile_thread_name(const char *name);
+
+// Call before a recording thread exits. Its ring keeps its events for export
+// and is handed to the next thread that starts recording, so short-lived
+// threads don't use up PROFILE_MAX_THREADS.
+void profile_thread_release(void);
+
+// Recording is on by default
+void profile_set_enabled(bool enabled);
+
+// Write every thread's buffered events as Chrome trace JSON (load it in
+// chrome://tracing or ui.perfetto.dev). Call while no other thread is
+// recording, e.g. between frames; events written concurrently may come out
+// torn. Returns false if the file can't be written.
+bool profile_export_chrome(const char *path);
+
+#endif // PROFILE_H
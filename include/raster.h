@@ -0,0 +1,89 @@
+#ifndef RASTER_H
+#define RASTER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "HandmadeMath.h"
+#include "mesh_format.h"
+
+// Software rasterizer for machines without a GPU. Renders the pyramid
+// shader's pipeline on the CPU: MeshVertex input, an MVP, a repeat-wrapped
+// texture without mipmaps, LESS_EQUAL depth and CCW front faces with back
+// faces culled. Draws are set up and binned into screen tiles on the calling
+// thread; raster_end() shades the tiles in parallel on the job system.
+
+// Tile edge in pixels, a multiple of 4 (one SIMD step)
+#define RASTER_TILE_SIZE 32
+
+// Triangles are clipped to x and y within this many w of the view axis,
+// wider than the screen so only triangles reaching far off-screen pay for it
+#define RASTER_GUARD_BAND 4.0f
+
+// RGBA8 texels, rows tightly packed, R in the lowest byte
+typedef struct {
+    const uint32_t *texels;
+    uint32_t        width;
+    uint32_t        height;
+    bool            nearest;   // point sampling instead of bilinear
+} RasterTexture;
+
+typedef struct RasterTri RasterTri;
+
+// Triangles touching a tile, in draw order
+typedef struct {
+    uint32_t *tris;
+    uint32_t  count;
+    uint32_t  capacity;
+} RasterBin;
+
+// Counts since raster_begin()
+typedef struct {
+    uint32_t triangles;     // submitted
+    uint32_t rasterized;    // set up after culling and clipping
+    uint32_t bin_entries;   // tile and triangle pairs shaded
+} RasterStats;
+
+typedef struct {
+    // Colour (RGBA8, R lowest) and window depth in [0, 1]. Rows are stride
+    // pixels apart, padded out to whole tiles.
+    uint32_t   *color;
+    float      *depth;
+    uint32_t    width;
+    uint32_t    height;
+    uint32_t    stride;
+    uint32_t    tiles_x;
+    uint32_t    tiles_y;
+
+    RasterBin  *bins;
+    RasterTri  *tris;
+    uint32_t    tri_count;
+    uint32_t    tri_capacity;
+    HMM_Vec4   *clip;         // the current draw's clip-space vertices
+    uint32_t    clip_capacity;
+
+    // Applied per tile by raster_end(), before its triangles
+    bool        clear;
+    uint32_t    clear_color;
+    float       clear_depth;
+
+    RasterStats stats;
+} Raster;
+
+bool raster_init(Raster *r, uint32_t width, uint32_t height);
+void raster_free(Raster *r);
+
+// Start a frame that clears to clear_color (RGBA8) and clear_depth
+void raster_begin(Raster *r, uint32_t clear_color, float clear_depth);
+
+// Transform, clip, cull and bin an indexed triangle list. vertices, indices
+// and tex must stay valid until raster_end(). tex may be NULL for white.
+// Returns false if binning ran out of memory; the draw is then incomplete.
+bool raster_draw(Raster *r, const MeshVertex *vertices, uint32_t vertex_count,
+                 const void *indices, uint32_t index_size, uint32_t index_count,
+                 HMM_Mat4 mvp, const RasterTexture *tex);
+
+// Shade every tile across the job system and empty the bins. color and
+// depth hold the frame afterwards.
+void raster_end(Raster *r);
+
+#endif // RASTER_H
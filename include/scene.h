@@ -0,0 +1,79 @@
+#ifndef SCENE_H
+#define SCENE_H
+
+#include <stdint.h>
+#include "HandmadeMath.h"
+#include "pool.h"
+
+#define SCENE_INVALID UINT32_MAX
+
+// Arrays are padded to a multiple of this many entities so SIMD loops can
+// run past count without a scalar tail
+#define SCENE_PAD 8
+
+// Entity storage in structure-of-arrays layout. Entities are kept dense in
+// [0, count) and iterated linearly by index. Removal moves the last entity,
+// so code that holds on to an entity across frames keeps its handle instead
+// and resolves it with scene_lookup().
+typedef struct {
+    uint32_t count;
+    uint32_t capacity;
+
+    // Generational handles, packed in step with the arrays below
+    Pool     entities;
+
+    // Local transform, one array per component so update loops can work on
+    // several entities per SIMD register
+    float *pos_x, *pos_y, *pos_z;
+    float *rot_x, *rot_y, *rot_z, *rot_w;   // unit quaternion
+    float *scale_x, *scale_y, *scale_z;
+
+    // World matrix cached by scene_update_transforms(). Contiguous, so it
+    // can be uploaded as an instance buffer as-is.
+    HMM_Mat4 *world;
+
+    // Object-space bounding sphere (from the mesh), and the world-space one
+    // derived from it by scene_update_transforms()
+    float *local_x, *local_y, *local_z, *local_radius;
+    float *sphere_x, *sphere_y, *sphere_z, *sphere_radius;
+
+    // Render resource handles
+    uint32_t *mesh;
+    uint32_t *material;
+
+    // Level of detail drawn last frame, the starting point for the next pick
+    uint8_t  *lod;
+} Scene;
+
+// Allocate storage for up to capacity entities. Returns false, with nothing
+// left allocated, if capacity is over POOL_MAX_CAPACITY or out of memory.
+bool     scene_init(Scene *scene, uint32_t capacity);
+void     scene_free(Scene *scene);
+
+// Returns the new entity's index, or SCENE_INVALID when full
+uint32_t scene_add(Scene *scene, HMM_Vec3 position, HMM_Quat rotation, HMM_Vec3 scale,
+                   uint32_t mesh, uint32_t material);
+
+// Set an entity's object-space bounding sphere (zero radius by default)
+void     scene_set_bounds(Scene *scene, uint32_t index, HMM_Vec3 center, float radius);
+
+// Swap-remove: the last entity moves into index. Anything holding entity
+// indices goes stale, so a Bvh over the scene needs bvh_build() (and new
+// bvh_split() subtrees) before the next cull; handles stay valid.
+void     scene_remove(Scene *scene, uint32_t index);
+
+// The handle of the entity at index, and the current index of a handle's
+// entity (SCENE_INVALID once it has been removed)
+uint32_t scene_handle(const Scene *scene, uint32_t index);
+uint32_t scene_lookup(const Scene *scene, uint32_t handle);
+
+// Rebuild world = T * R * S and the world bounding sphere of every entity.
+// Returns the number of entities whose world sphere changed and, if moved is
+// not NULL, writes their indices to it (room for count entries needed).
+uint32_t scene_update_transforms(Scene *scene, uint32_t *moved);
+
+// scene_update_transforms() for entities [begin, end) only, so the update can
+// be split across jobs. moved[0] receives the first changed index.
+uint32_t scene_update_transforms_range(Scene *scene, uint32_t begin, uint32_t end, uint32_t *moved);
+
+#endif // SCENE_H
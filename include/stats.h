@@ -0,0 +1,59 @@
+#ifndef STATS_H
+#define STATS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "frame_timing.h"
+
+// Frames summarised by default
+#define STATS_DEFAULT_WINDOW 240
+
+// Per-frame values tracked over a rolling window. The gfx counts come from
+// sokol_gfx's own frame stats, so they include work issued outside the
+// draw lists (buffer updates, the stream rings).
+typedef enum {
+    STAT_CPU_MS,          // frame_timing total
+    STAT_GPU_MS,          // FRAME_GPU_MAIN, 0 where unavailable
+    STAT_PASSES,
+    STAT_PIPELINES,       // sg_apply_pipeline() calls
+    STAT_BINDINGS,        // sg_apply_bindings() calls
+    STAT_UNIFORMS,        // sg_apply_uniforms() calls
+    STAT_DRAWS,           // sg_draw() and sg_draw_ex() calls
+    STAT_UNIFORM_BYTES,
+    STAT_UPLOAD_BYTES,    // sg_update_buffer/append_buffer/update_image
+    STAT_OCCLUDED,        // FRAME_COUNTER_OCCLUDED
+    STAT_COUNT,
+} Stat;
+
+typedef struct {
+    double min;
+    double avg;
+    double p99;
+    double max;
+} StatSummary;
+
+// Enable sokol_gfx stats and allocate a window of frames (0 for
+// STATS_DEFAULT_WINDOW). Call after sg_setup().
+bool        stats_setup(uint32_t window);
+void        stats_shutdown(void);
+
+// Record the frame just committed. Call after sg_commit() and
+// frame_timing_end(); timing is that frame's FrameTiming.
+void        stats_frame(const FrameTiming *timing);
+
+// Frames recorded so far, and true once every window frames (when a fresh
+// summary is worth showing)
+uint64_t    stats_frame_count(void);
+bool        stats_window_done(void);
+
+// min/avg/p99/max over the last window frames (fewer before the window
+// fills). Does not allocate.
+StatSummary stats_summary(Stat stat);
+
+const char *stats_name(Stat stat);
+
+// One row per stat: name,min,avg,p99,max,frames. Returns false if the file
+// can't be written.
+bool        stats_write_csv(const char *path);
+
+#endif // STATS_H
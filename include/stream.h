@@ -0,0 +1,67 @@
+#ifndef STREAM_H
+#define STREAM_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "sokol_gfx.h"
+
+// GPU buffers rotated per frame, so the CPU fills one while the GPU may
+// still read the last ones
+#define STREAM_FRAMES 3
+
+// Returned by stream_append() when the frame's space is used up
+#define STREAM_FULL UINT32_MAX
+
+// Per-frame vertex or index data (debug lines, particles, procedural
+// meshes). Data is written into a CPU staging area and uploaded with one
+// sg_append_buffer() per stream_flush(), so nothing is allocated per frame
+// and draws can bind the buffer at the returned offsets. Capacity only
+// changes through stream_reserve(); data past it is dropped and counted
+// rather than reallocating.
+typedef struct {
+    sg_buffer   buffers[STREAM_FRAMES];
+    bool        index;
+    const char *label;
+    uint32_t    current;
+    uint8_t    *staging;
+    size_t      capacity;
+    size_t      used;
+    size_t      flushed;    // staging bytes already appended to the buffer
+    size_t      dropped;    // bytes refused this frame
+} Stream;
+
+// capacity bytes per frame. index selects an index buffer over a vertex
+// buffer. Call after sg_setup().
+bool      stream_init(Stream *stream, size_t capacity, bool index, const char *label);
+void      stream_destroy(Stream *stream);
+
+// Grow to at least capacity bytes per frame, replacing the buffers. Call
+// before anything is allocated in the frame. On failure the stream keeps
+// its old capacity and false is returned.
+bool      stream_reserve(Stream *stream, size_t capacity);
+
+// Room for size bytes in this frame's data, or NULL when full. offset
+// receives the byte offset to bind or draw from. Allocations are 4-byte
+// aligned. Not thread-safe.
+void     *stream_alloc(Stream *stream, size_t size, uint32_t *offset);
+
+// Copy size bytes in. Returns their offset, or STREAM_FULL.
+uint32_t  stream_append(Stream *stream, const void *data, size_t size);
+
+// Hand back this frame's allocations past used bytes, e.g. after packing
+// partly filled ones down, so stream_flush() uploads only what is kept.
+// Flushed data can't be given back.
+void      stream_rewind(Stream *stream, size_t used);
+
+// Upload everything allocated since the last flush. Call before the draws
+// that read it; several flushes per frame are fine.
+void      stream_flush(Stream *stream);
+
+// This frame's buffer
+sg_buffer stream_buffer(const Stream *stream);
+
+// Move to the next buffer and start an empty frame. Call after sg_commit().
+void      stream_next_frame(Stream *stream);
+
+#endif // STREAM_H
@@ -0,0 +1,49 @@
+#ifndef TEXTURE_H
+#define TEXTURE_H
+
+#include <stdbool.h>
+#include "sokol_gfx.h"
+
+// Largest image file texture_load() will fetch
+#define TEXTURE_MAX_FILE_SIZE (4 * 1024 * 1024)
+
+// Max number of textures loading at the same time
+#define TEXTURE_MAX_PENDING 16
+
+typedef enum {
+    TEXTURE_EMPTY,
+    TEXTURE_LOADING,   // fetch or decode still in flight
+    TEXTURE_READY,
+    TEXTURE_FAILED,
+} TextureState;
+
+typedef struct {
+    // Allocated up front by texture_load(), initialized once decoded
+    sg_image     img;
+    sg_view      view;
+    TextureState state;
+} Texture;
+
+// Call after sg_setup(). Starts the sokol_fetch IO threads.
+void    texture_setup(void);
+
+// Call before sg_shutdown(). Waits for in-flight decodes.
+void    texture_shutdown(void);
+
+// Load an image file. A cooked cache next to it (foo.png -> foo.tex, see
+// make textures) is mapped and uploaded with its mip chain right away;
+// otherwise the image loads in the background and tex must stay at the same
+// address until it has finished.
+bool    texture_load(Texture *tex, const char *path);
+
+// Call once per frame: pumps sokol_fetch and uploads finished decodes
+void    texture_update(void);
+
+// True while any texture_load() has not finished, i.e. texture_update()
+// still has a fetch, decode or upload to do
+bool    texture_pending(void);
+
+// The texture's view, or a placeholder view while it is not ready
+sg_view texture_view(const Texture *tex);
+
+#endif // TEXTURE_H
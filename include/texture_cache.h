@@ -0,0 +1,31 @@
+#ifndef TEXTURE_CACHE_H
+#define TEXTURE_CACHE_H
+
+#include <stdint.h>
+
+// On-disk layout of a cooked texture (.tex), written by tools/texcook.c and
+// memory-mapped by texture_load(). A header followed by every mip level of an
+// RGBA8 image, largest first, each starting on a TEXCACHE_ALIGN boundary so
+// the mapped slices can go straight to sg_make_image().
+#define TEXCACHE_MAGIC    0x58455433u  // "3TEX"
+#define TEXCACHE_VERSION  1
+#define TEXCACHE_MAX_MIPS 16           // matches SG_MAX_MIPMAPS
+#define TEXCACHE_ALIGN    16
+#define TEXCACHE_MAX_SIZE 16384        // per side, so every mip's size fits a uint32_t
+
+typedef struct {
+    uint32_t offset;  // from the start of the file
+    uint32_t size;
+} TexCacheMip;
+
+typedef struct {
+    uint32_t    magic;
+    uint32_t    version;
+    uint32_t    width;
+    uint32_t    height;
+    uint32_t    num_mips;
+    uint32_t    reserved;
+    TexCacheMip mips[TEXCACHE_MAX_MIPS];
+} TexCacheHeader;
+
+#endif // TEXTURE_CACHE_H
@@ -0,0 +1,38 @@
+#ifndef TRANSFORM_H
+#define TRANSFORM_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "HandmadeMath.h"
+
+// Batch matrix kernels. The best implementation the CPU supports is picked
+// on first use; transform_use() overrides it (for benchmarks and testing).
+
+typedef enum {
+    TRANSFORM_SCALAR,
+    TRANSFORM_SSE,    // SSE2, baseline on x86-64
+    TRANSFORM_AVX2,   // AVX2 + FMA
+    TRANSFORM_BACKEND_COUNT,
+} TransformBackend;
+
+// Transform components in structure-of-arrays layout
+typedef struct {
+    const float *pos[3];
+    const float *rot[4];     // unit quaternion x, y, z, w
+    const float *scale[3];
+} TransformSoA;
+
+// world[i] = T * R * S for count transforms
+void             transform_compose(const TransformSoA *in, HMM_Mat4 *world, uint32_t count);
+
+// out[i] = m * in[i], e.g. view-projection times world
+void             transform_mul(HMM_Mat4 m, const HMM_Mat4 *in, HMM_Mat4 *out, uint32_t count);
+
+// Backend in use, and its name for reports
+TransformBackend transform_backend(void);
+const char      *transform_backend_name(TransformBackend backend);
+
+// Switch backend. Returns false if the CPU does not support it.
+bool             transform_use(TransformBackend backend);
+
+#endif // TRANSFORM_H
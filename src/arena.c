@@ -0,0 +1,113 @@
+#include "arena.h"
+#include <stdlib.h>
+
+// Base blocks are cache-line aligned; so are overflow blocks, which start
+// after their header
+#define ARENA_ALIGN 64
+
+struct ArenaBlock {
+    ArenaBlock *next;
+    uint8_t     pad[ARENA_ALIGN - sizeof(ArenaBlock *)];
+};
+
+static size_t align_up(size_t n, size_t align) {
+    return (n + align - 1) & ~(align - 1);
+}
+
+static uint8_t *alloc_base(size_t capacity) {
+    return capacity > 0 ? aligned_alloc(ARENA_ALIGN, align_up(capacity, ARENA_ALIGN)) : NULL;
+}
+
+void arena_init(Arena *arena, size_t capacity) {
+    arena->capacity = align_up(capacity, ARENA_ALIGN);
+    arena->base     = alloc_base(arena->capacity);
+    arena->overflow = NULL;
+    atomic_init(&arena->used, 0);
+    atomic_init(&arena->overflow_size, 0);
+    pthread_mutex_init(&arena->overflow_lock, NULL);
+}
+
+static void free_overflow(Arena *arena) {
+    for (ArenaBlock *b = arena->overflow; b;) {
+        ArenaBlock *next = b->next;
+        free(b);
+        b = next;
+    }
+    arena->overflow = NULL;
+}
+
+void arena_free(Arena *arena) {
+    free_overflow(arena);
+    free(arena->base);
+    pthread_mutex_destroy(&arena->overflow_lock);
+    arena->base     = NULL;
+    arena->capacity = 0;
+}
+
+static void *overflow_alloc(Arena *arena, size_t size, size_t align) {
+    if (align < ARENA_ALIGN) align = ARENA_ALIGN;
+    ArenaBlock *block = aligned_alloc(align, align_up(sizeof(ArenaBlock), align) + align_up(size, align));
+    if (!block) return NULL;
+
+    pthread_mutex_lock(&arena->overflow_lock);
+    block->next     = arena->overflow;
+    arena->overflow = block;
+    pthread_mutex_unlock(&arena->overflow_lock);
+    atomic_fetch_add(&arena->overflow_size, size + align);
+    return (uint8_t *)block + align_up(sizeof(ArenaBlock), align);
+}
+
+void *arena_alloc(Arena *arena, size_t size, size_t align) {
+    size_t cur = atomic_load_explicit(&arena->used, memory_order_relaxed);
+    for (;;) {
+        size_t start = align_up(cur, align);
+        size_t end   = start + size;
+        if (end > arena->capacity) return overflow_alloc(arena, size, align);
+        if (atomic_compare_exchange_weak_explicit(&arena->used, &cur, end,
+                                                  memory_order_relaxed, memory_order_relaxed)) {
+            return arena->base + start;
+        }
+    }
+}
+
+void arena_reset(Arena *arena) {
+    size_t overflow = atomic_load(&arena->overflow_size);
+    if (overflow > 0) {
+        // Grow to hold everything this round needed, with headroom
+        size_t peak = atomic_load(&arena->used) + overflow;
+        free_overflow(arena);
+        free(arena->base);
+        arena->capacity = align_up(peak + peak / 2, ARENA_ALIGN);
+        arena->base     = alloc_base(arena->capacity);
+        atomic_store(&arena->overflow_size, 0);
+    }
+    atomic_store(&arena->used, 0);
+}
+
+size_t arena_used(Arena *arena) {
+    return atomic_load(&arena->used) + atomic_load(&arena->overflow_size);
+}
+
+void frame_arena_init(FrameArena *fa, size_t capacity) {
+    arena_init(&fa->arenas[0], capacity);
+    arena_init(&fa->arenas[1], capacity);
+    fa->current = 0;
+}
+
+void frame_arena_free(FrameArena *fa) {
+    arena_free(&fa->arenas[0]);
+    arena_free(&fa->arenas[1]);
+}
+
+Arena *frame_arena_current(FrameArena *fa) {
+    return &fa->arenas[fa->current];
+}
+
+Arena *frame_arena_previous(FrameArena *fa) {
+    return &fa->arenas[fa->current ^ 1];
+}
+
+void frame_arena_swap(FrameArena *fa) {
+    fa->current ^= 1;
+    arena_reset(&fa->arenas[fa->current]);
+}
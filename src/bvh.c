@@ -0,0 +1,451 @@
+#include "bvh.h"
+#include <float.h>
+#include <math.h>
+#include <string.h>
+#include <stdlib.h>
+
+// SAH bins per axis
+#define BVH_BINS 12
+
+typedef struct {
+    float min[3];
+    float max[3];
+} Bounds;
+
+static Bounds bounds_empty(void) {
+    return (Bounds){ { FLT_MAX, FLT_MAX, FLT_MAX }, { -FLT_MAX, -FLT_MAX, -FLT_MAX } };
+}
+
+static void bounds_grow_sphere(Bounds *b, const Scene *scene, uint32_t e) {
+    float c[3] = { scene->sphere_x[e], scene->sphere_y[e], scene->sphere_z[e] };
+    float r    = scene->sphere_radius[e];
+    for (int a = 0; a < 3; a++) {
+        b->min[a] = HMM_MIN(b->min[a], c[a] - r);
+        b->max[a] = HMM_MAX(b->max[a], c[a] + r);
+    }
+}
+
+static void bounds_grow(Bounds *b, const Bounds *other) {
+    for (int a = 0; a < 3; a++) {
+        b->min[a] = HMM_MIN(b->min[a], other->min[a]);
+        b->max[a] = HMM_MAX(b->max[a], other->max[a]);
+    }
+}
+
+// Half the surface area, which is all SAH needs
+static float bounds_area(const Bounds *b) {
+    float dx = b->max[0] - b->min[0];
+    float dy = b->max[1] - b->min[1];
+    float dz = b->max[2] - b->min[2];
+    if (dx < 0.0f) return 0.0f;
+    return dx * dy + dy * dz + dz * dx;
+}
+
+static void node_set_bounds(BvhNode *node, const Bounds *b) {
+    for (int a = 0; a < 3; a++) {
+        node->min[a] = b->min[a];
+        node->max[a] = b->max[a];
+    }
+}
+
+static Bounds leaf_bounds(const Bvh *bvh, const Scene *scene, const BvhNode *node) {
+    Bounds b = bounds_empty();
+    for (uint32_t i = 0; i < node->count; i++) bounds_grow_sphere(&b, scene, bvh->items[node->first + i]);
+    return b;
+}
+
+static bool node_bounds_equal(const BvhNode *node, const Bounds *b) {
+    return memcmp(node->min, b->min, sizeof(b->min)) == 0 && memcmp(node->max, b->max, sizeof(b->max)) == 0;
+}
+
+static Bounds children_bounds(const Bvh *bvh, const BvhNode *node) {
+    const BvhNode *l = &bvh->nodes[node->first];
+    const BvhNode *r = &bvh->nodes[node->first + 1];
+    Bounds b;
+    for (int a = 0; a < 3; a++) {
+        b.min[a] = HMM_MIN(l->min[a], r->min[a]);
+        b.max[a] = HMM_MAX(l->max[a], r->max[a]);
+    }
+    return b;
+}
+
+void bvh_init(Bvh *bvh, uint32_t capacity) {
+    *bvh = (Bvh){ .capacity = capacity };
+    // A binary tree with at most one entity per leaf has 2n - 1 nodes
+    size_t max_nodes = capacity > 0 ? 2 * (size_t)capacity - 1 : 1;
+    bvh->nodes  = malloc(max_nodes * sizeof(BvhNode));
+    bvh->parent = malloc(max_nodes * sizeof(uint32_t));
+    bvh->items  = malloc((capacity > 0 ? capacity : 1) * sizeof(uint32_t));
+    bvh->leaf   = malloc((capacity > 0 ? capacity : 1) * sizeof(uint32_t));
+}
+
+void bvh_free(Bvh *bvh) {
+    free(bvh->nodes);
+    free(bvh->parent);
+    free(bvh->items);
+    free(bvh->leaf);
+    *bvh = (Bvh){0};
+}
+
+// Build-time copy of an entity's world sphere, kept in the same order as
+// Bvh.items so the split passes read memory linearly
+typedef struct {
+    float c[3];
+    float r;
+} BuildRef;
+
+static Bounds refs_bounds(const BuildRef *refs, uint32_t count) {
+    Bounds b = bounds_empty();
+    for (uint32_t i = 0; i < count; i++) {
+        for (int a = 0; a < 3; a++) {
+            b.min[a] = HMM_MIN(b.min[a], refs[i].c[a] - refs[i].r);
+            b.max[a] = HMM_MAX(b.max[a], refs[i].c[a] + refs[i].r);
+        }
+    }
+    return b;
+}
+
+// Pick the SAH-cheapest bin boundary along any axis. Returns false when the
+// centres can't be separated.
+static bool find_split(const BuildRef *refs, uint32_t count, int *out_axis, float *out_pos) {
+    float cmin[3] = { FLT_MAX, FLT_MAX, FLT_MAX };
+    float cmax[3] = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+    for (uint32_t i = 0; i < count; i++) {
+        for (int a = 0; a < 3; a++) {
+            cmin[a] = HMM_MIN(cmin[a], refs[i].c[a]);
+            cmax[a] = HMM_MAX(cmax[a], refs[i].c[a]);
+        }
+    }
+
+    float best_cost = FLT_MAX;
+    for (int a = 0; a < 3; a++) {
+        float extent = cmax[a] - cmin[a];
+        if (extent <= 0.0f) continue;
+
+        Bounds   bins[BVH_BINS];
+        uint32_t counts[BVH_BINS] = {0};
+        for (int b = 0; b < BVH_BINS; b++) bins[b] = bounds_empty();
+        float scale = BVH_BINS / extent;
+        for (uint32_t i = 0; i < count; i++) {
+            const BuildRef *ref = &refs[i];
+            int b = (int)((ref->c[a] - cmin[a]) * scale);
+            if (b >= BVH_BINS) b = BVH_BINS - 1;
+            counts[b]++;
+            for (int k = 0; k < 3; k++) {
+                bins[b].min[k] = HMM_MIN(bins[b].min[k], ref->c[k] - ref->r);
+                bins[b].max[k] = HMM_MAX(bins[b].max[k], ref->c[k] + ref->r);
+            }
+        }
+
+        // Sweep from the right to get the cost of everything past each boundary
+        float    right_area[BVH_BINS - 1];
+        uint32_t right_count[BVH_BINS - 1];
+        Bounds   acc = bounds_empty();
+        uint32_t n   = 0;
+        for (int b = BVH_BINS - 1; b > 0; b--) {
+            bounds_grow(&acc, &bins[b]);
+            n += counts[b];
+            right_area[b - 1]  = bounds_area(&acc);
+            right_count[b - 1] = n;
+        }
+        acc = bounds_empty();
+        n   = 0;
+        for (int b = 0; b < BVH_BINS - 1; b++) {
+            bounds_grow(&acc, &bins[b]);
+            n += counts[b];
+            if (n == 0 || right_count[b] == 0) continue;
+            float cost = bounds_area(&acc) * (float)n + right_area[b] * (float)right_count[b];
+            if (cost < best_cost) {
+                best_cost = cost;
+                *out_axis = a;
+                *out_pos  = cmin[a] + (float)(b + 1) / scale;
+            }
+        }
+    }
+    return best_cost < FLT_MAX;
+}
+
+void bvh_build(Bvh *bvh, const Scene *scene) {
+    uint32_t count = scene->count < bvh->capacity ? scene->count : bvh->capacity;
+    BuildRef *refs = malloc((count > 0 ? count : 1) * sizeof(BuildRef));
+    for (uint32_t i = 0; i < count; i++) {
+        bvh->items[i] = i;
+        refs[i] = (BuildRef){ { scene->sphere_x[i], scene->sphere_y[i], scene->sphere_z[i] }, scene->sphere_radius[i] };
+    }
+    bvh->item_count = count;
+    bvh->node_count = 1;
+    bvh->nodes[0]   = (BvhNode){ .first = 0, .count = count };
+    bvh->parent[0]  = BVH_INVALID;
+
+    Bounds root = refs_bounds(refs, count);
+    node_set_bounds(&bvh->nodes[0], &root);
+
+    // Nodes still to split, with their depth
+    uint32_t stack[BVH_MAX_DEPTH + 1];
+    uint32_t depth[BVH_MAX_DEPTH + 1];
+    int      top = 0;
+    stack[top] = 0;
+    depth[top] = 0;
+    top++;
+
+    while (top > 0) {
+        top--;
+        uint32_t index = stack[top];
+        uint32_t d     = depth[top];
+        BvhNode *node  = &bvh->nodes[index];
+
+        int   axis = 0;
+        float pos  = 0.0f;
+        BuildRef *r     = refs + node->first;
+        uint32_t *items = bvh->items + node->first;
+        if (node->count > BVH_LEAF_SIZE && d + 1 < BVH_MAX_DEPTH && find_split(r, node->count, &axis, &pos)) {
+            // Partition in place around the split plane
+            uint32_t lo = 0;
+            uint32_t hi = node->count;
+            while (lo < hi) {
+                if (r[lo].c[axis] < pos) {
+                    lo++;
+                } else {
+                    hi--;
+                    BuildRef tr = r[lo];
+                    r[lo]       = r[hi];
+                    r[hi]       = tr;
+                    uint32_t ti = items[lo];
+                    items[lo]   = items[hi];
+                    items[hi]   = ti;
+                }
+            }
+
+            if (lo > 0 && lo < node->count) {
+                uint32_t left = bvh->node_count;
+                bvh->node_count += 2;
+                bvh->nodes[left]     = (BvhNode){ .first = node->first,      .count = lo };
+                bvh->nodes[left + 1] = (BvhNode){ .first = node->first + lo, .count = node->count - lo };
+                node->first = left;
+                node->count = 0;
+
+                for (uint32_t c = left; c <= left + 1; c++) {
+                    Bounds b = refs_bounds(refs + bvh->nodes[c].first, bvh->nodes[c].count);
+                    node_set_bounds(&bvh->nodes[c], &b);
+                    bvh->parent[c] = index;
+                    stack[top] = c;
+                    depth[top] = d + 1;
+                    top++;
+                }
+                continue;
+            }
+        }
+
+        // Stays a leaf
+        for (uint32_t i = 0; i < node->count; i++) bvh->leaf[items[i]] = index;
+    }
+    free(refs);
+}
+
+void bvh_refit(Bvh *bvh, const Scene *scene) {
+    // Children are stored after their parent, so a reverse sweep visits every
+    // child before the node that bounds it
+    for (uint32_t n = bvh->node_count; n-- > 0;) {
+        BvhNode *node = &bvh->nodes[n];
+        Bounds   b    = node->count > 0 ? leaf_bounds(bvh, scene, node) : children_bounds(bvh, node);
+        node_set_bounds(node, &b);
+    }
+}
+
+void bvh_refit_moved(Bvh *bvh, const Scene *scene, const uint32_t *moved, uint32_t count) {
+    for (uint32_t i = 0; i < count; i++) {
+        if (moved[i] >= bvh->item_count) continue;
+        uint32_t n = bvh->leaf[moved[i]];
+        Bounds   b = leaf_bounds(bvh, scene, &bvh->nodes[n]);
+        // Walk up until a node's bounds come out unchanged; everything above
+        // it is then already correct
+        while (!node_bounds_equal(&bvh->nodes[n], &b)) {
+            node_set_bounds(&bvh->nodes[n], &b);
+            n = bvh->parent[n];
+            if (n == BVH_INVALID) break;
+            b = children_bounds(bvh, &bvh->nodes[n]);
+        }
+    }
+}
+
+// Items under a node: from the leftmost leaf's first to the rightmost leaf's end
+static BvhSubtree subtree(const Bvh *bvh, uint32_t node) {
+    const BvhNode *l = &bvh->nodes[node];
+    const BvhNode *r = l;
+    while (l->count == 0) l = &bvh->nodes[l->first];
+    while (r->count == 0) r = &bvh->nodes[r->first + 1];
+    return (BvhSubtree){ .node = node, .first = l->first, .count = r->first + r->count - l->first };
+}
+
+uint32_t bvh_split(const Bvh *bvh, BvhSubtree *out, uint32_t max) {
+    if (bvh->item_count == 0 || max == 0) return 0;
+
+    uint32_t n = 1;
+    out[0] = subtree(bvh, 0);
+    while (n < max) {
+        // Largest subtree that can still be split
+        uint32_t best = UINT32_MAX;
+        for (uint32_t i = 0; i < n; i++) {
+            if (bvh->nodes[out[i].node].count == 0 && (best == UINT32_MAX || out[i].count > out[best].count)) {
+                best = i;
+            }
+        }
+        if (best == UINT32_MAX) break;
+
+        // Replace it with its children, keeping items order
+        uint32_t left = bvh->nodes[out[best].node].first;
+        for (uint32_t i = n; i > best + 1; i--) out[i] = out[i - 1];
+        out[best]     = subtree(bvh, left);
+        out[best + 1] = subtree(bvh, left + 1);
+        n++;
+    }
+    return n;
+}
+
+uint32_t bvh_cull_frustum(const Bvh *bvh, const Scene *scene, const Frustum *f, uint32_t *visible) {
+    return bvh_cull_frustum_subtree(bvh, scene, f, 0, visible);
+}
+
+uint32_t bvh_cull_frustum_subtree(const Bvh *bvh, const Scene *scene, const Frustum *f, uint32_t root,
+                                  uint32_t *visible) {
+    if (bvh->item_count == 0) return 0;
+
+    // A node whose box is fully inside needs no more tests below it
+    struct CullEntry { uint32_t node; bool inside; } stack[BVH_MAX_DEPTH + 1];
+    int      top = 0;
+    uint32_t n   = 0;
+    stack[top++] = (struct CullEntry){ root, false };
+
+    while (top > 0) {
+        top--;
+        const BvhNode *node   = &bvh->nodes[stack[top].node];
+        bool           inside = stack[top].inside;
+        if (!inside) {
+            FrustumClass c = frustum_classify_aabb(f, HMM_V3(node->min[0], node->min[1], node->min[2]),
+                                                      HMM_V3(node->max[0], node->max[1], node->max[2]));
+            if (c == FRUSTUM_OUTSIDE) continue;
+            inside = c == FRUSTUM_INSIDE;
+        }
+
+        if (node->count == 0) {
+            stack[top++] = (struct CullEntry){ node->first + 1, inside };
+            stack[top++] = (struct CullEntry){ node->first,     inside };
+            continue;
+        }
+        const uint32_t *items = bvh->items + node->first;
+        for (uint32_t i = 0; i < node->count; i++) {
+            uint32_t e = items[i];
+            if (inside || frustum_test_sphere(f, HMM_V3(scene->sphere_x[e], scene->sphere_y[e], scene->sphere_z[e]),
+                                              scene->sphere_radius[e])) {
+                visible[n++] = e;
+            }
+        }
+    }
+    return n;
+}
+
+// Slab test. Returns the entry distance, or FLT_MAX on a miss.
+static float ray_aabb(const BvhNode *node, const float origin[3], const float inv_dir[3], float max_t) {
+    float t0 = 0.0f;
+    float t1 = max_t;
+    for (int a = 0; a < 3; a++) {
+        float near = (node->min[a] - origin[a]) * inv_dir[a];
+        float far  = (node->max[a] - origin[a]) * inv_dir[a];
+        if (near > far) {
+            float t = near;
+            near    = far;
+            far     = t;
+        }
+        t0 = HMM_MAX(t0, near);
+        t1 = HMM_MIN(t1, far);
+    }
+    return t0 <= t1 ? t0 : FLT_MAX;
+}
+
+bool bvh_raycast(const Bvh *bvh, const Scene *scene, HMM_Vec3 origin, HMM_Vec3 dir, float max_t,
+                 BvhHit *hit) {
+    if (bvh->item_count == 0) return false;
+
+    float o[3]       = { origin.X, origin.Y, origin.Z };
+    float inv_dir[3] = { 1.0f / dir.X, 1.0f / dir.Y, 1.0f / dir.Z };
+    float best_t     = max_t;
+    bool  found      = false;
+
+    uint32_t stack[BVH_MAX_DEPTH + 1];
+    int      top = 0;
+    if (ray_aabb(&bvh->nodes[0], o, inv_dir, best_t) == FLT_MAX) return false;
+    stack[top++] = 0;
+
+    while (top > 0) {
+        const BvhNode *node = &bvh->nodes[stack[--top]];
+        if (node->count == 0) {
+            // Visit the nearer child first so it can shrink best_t for the other
+            float tl = ray_aabb(&bvh->nodes[node->first],     o, inv_dir, best_t);
+            float tr = ray_aabb(&bvh->nodes[node->first + 1], o, inv_dir, best_t);
+            uint32_t near = node->first, far = node->first + 1;
+            if (tr < tl) {
+                float t = tl;
+                tl = tr, tr = t;
+                near = node->first + 1, far = node->first;
+            }
+            if (tr != FLT_MAX) stack[top++] = far;
+            if (tl != FLT_MAX) stack[top++] = near;
+            continue;
+        }
+
+        for (uint32_t i = 0; i < node->count; i++) {
+            uint32_t e  = bvh->items[node->first + i];
+            HMM_Vec3 oc = HMM_SubV3(HMM_V3(scene->sphere_x[e], scene->sphere_y[e], scene->sphere_z[e]), origin);
+            float    r  = scene->sphere_radius[e];
+            float    tc = HMM_DotV3(oc, dir);
+            float    d2 = HMM_DotV3(oc, oc) - tc * tc;
+            if (d2 > r * r) continue;
+            float half = sqrtf(r * r - d2);
+            // Origin inside the sphere counts as a hit at the exit point
+            float t    = tc - half >= 0.0f ? tc - half : tc + half;
+            if (t < 0.0f || t >= best_t) continue;
+            best_t = t;
+            found  = true;
+            if (hit) *hit = (BvhHit){ .entity = e, .t = t };
+        }
+    }
+    return found;
+}
+
+uint32_t bvh_query_radius(const Bvh *bvh, const Scene *scene, HMM_Vec3 center, float radius,
+                          uint32_t *out, uint32_t max_out) {
+    if (bvh->item_count == 0) return 0;
+
+    float    c[3] = { center.X, center.Y, center.Z };
+    uint32_t stack[BVH_MAX_DEPTH + 1];
+    int      top = 0;
+    uint32_t n   = 0;
+    stack[top++] = 0;
+
+    while (top > 0 && n < max_out) {
+        const BvhNode *node = &bvh->nodes[stack[--top]];
+
+        // Squared distance from the query centre to the box
+        float d2 = 0.0f;
+        for (int a = 0; a < 3; a++) {
+            float v = HMM_MAX(HMM_MAX(node->min[a] - c[a], 0.0f), c[a] - node->max[a]);
+            d2 += v * v;
+        }
+        if (d2 > radius * radius) continue;
+
+        if (node->count == 0) {
+            stack[top++] = node->first + 1;
+            stack[top++] = node->first;
+            continue;
+        }
+        for (uint32_t i = 0; i < node->count && n < max_out; i++) {
+            uint32_t e  = bvh->items[node->first + i];
+            float    dx = scene->sphere_x[e] - c[0];
+            float    dy = scene->sphere_y[e] - c[1];
+            float    dz = scene->sphere_z[e] - c[2];
+            float    r  = radius + scene->sphere_radius[e];
+            if (dx * dx + dy * dy + dz * dz <= r * r) out[n++] = e;
+        }
+    }
+    return n;
+}
@@ -1,4 +1,5 @@
 #include "camera.h"
+#include "profile.h"
 
 void camera_init(Camera *cam, HMM_Vec3 position, float yaw) {
     cam->position   = position;
@@ -12,14 +13,14 @@ void camera_init(Camera *cam, HMM_Vec3 position, float yaw) {
     cam->pitch_max  = CAMERA_DEFAULT_PITCH_MAX;
 }
 
+HMM_Vec3 camera_forward(const Camera *cam) {
+    return HMM_V3(cosf(cam->pitch) * sinf(cam->yaw),
+                  sinf(cam->pitch),
+                  cosf(cam->pitch) * cosf(cam->yaw));
+}
+
 HMM_Mat4 camera_view(const Camera *cam) {
-    // Derive forward vector from yaw and pitch
-    HMM_Vec3 forward = {{
-        cosf(cam->pitch) * sinf(cam->yaw),
-        sinf(cam->pitch),
-        cosf(cam->pitch) * cosf(cam->yaw),
-    }};
-    HMM_Vec3 target = HMM_AddV3(cam->position, forward);
+    HMM_Vec3 target = HMM_AddV3(cam->position, camera_forward(cam));
     return HMM_LookAt_RH(cam->position, target, HMM_V3(0.0f, 1.0f, 0.0f));
 }
 
@@ -28,6 +29,7 @@ HMM_Mat4 camera_projection(const Camera *cam, float aspect) {
 }
 
 void camera_move(Camera *cam, MoveFlags flags, float dt) {
+    profile_begin("camera_move");
     // Movement is on the horizontal plane — pitch doesn't affect direction
     HMM_Vec3 forward = HMM_V3( sinf(cam->yaw), 0.0f,  cosf(cam->yaw));
     HMM_Vec3 right   = HMM_V3(-cosf(cam->yaw), 0.0f,  sinf(cam->yaw));
@@ -37,12 +39,15 @@ void camera_move(Camera *cam, MoveFlags flags, float dt) {
     if (flags & MOVE_BACK)    cam->position = HMM_AddV3(cam->position, HMM_MulV3F(forward, -speed));
     if (flags & MOVE_RIGHT)   cam->position = HMM_AddV3(cam->position, HMM_MulV3F(right,    speed));
     if (flags & MOVE_LEFT)    cam->position = HMM_AddV3(cam->position, HMM_MulV3F(right,   -speed));
+    profile_end();
 }
 
 void camera_look(Camera *cam, float dx, float dy) {
+    profile_begin("camera_look");
     cam->yaw   -= dx * cam->look_speed;
     cam->pitch -= dy * cam->look_speed;
 
     if (cam->pitch >  cam->pitch_max) cam->pitch =  cam->pitch_max;
     if (cam->pitch < -cam->pitch_max) cam->pitch = -cam->pitch_max;
+    profile_end();
 }
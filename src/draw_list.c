@@ -0,0 +1,165 @@
+#include "draw_list.h"
+#include "job.h"
+#include <stdlib.h>
+#include <string.h>
+
+void draw_lists_init(DrawLists *dl, uint32_t thread_count, uint32_t cmds_per_thread,
+                     uint32_t uniform_bytes_per_thread) {
+    *dl = (DrawLists){ .list_count = thread_count > 0 ? thread_count : 1 };
+    dl->lists = malloc(dl->list_count * sizeof(DrawList));
+    for (uint32_t i = 0; i < dl->list_count; i++) {
+        dl->lists[i] = (DrawList){
+            .capacity         = cmds_per_thread > 0 ? cmds_per_thread : 1,
+            .uniform_capacity = uniform_bytes_per_thread > 0 ? uniform_bytes_per_thread : DRAW_UNIFORM_ALIGN,
+        };
+    }
+}
+
+uint64_t draw_key(uint32_t pass, sg_pipeline pipeline, uint32_t material, float depth) {
+    // Non-negative floats order the same as their bit patterns; keep the top
+    // DRAW_KEY_DEPTH_BITS of the 31 that can be set
+    uint32_t bits;
+    if (!(depth > 0.0f)) depth = 0.0f;
+    memcpy(&bits, &depth, sizeof(bits));
+    uint64_t d = bits >> (31 - DRAW_KEY_DEPTH_BITS);
+
+    uint64_t mask_pass     = (1u << DRAW_KEY_PASS_BITS) - 1;
+    uint64_t mask_pipeline = (1u << DRAW_KEY_PIPELINE_BITS) - 1;
+    uint64_t mask_material = (1u << DRAW_KEY_MATERIAL_BITS) - 1;
+    return ((uint64_t)pass & mask_pass) << DRAW_KEY_PASS_SHIFT |
+           ((uint64_t)pipeline.id & mask_pipeline) << DRAW_KEY_PIPELINE_SHIFT |
+           ((uint64_t)material & mask_material) << DRAW_KEY_MATERIAL_SHIFT |
+           d << DRAW_KEY_DEPTH_SHIFT;
+}
+
+void draw_lists_free(DrawLists *dl) {
+    free(dl->lists);
+    *dl = (DrawLists){0};
+}
+
+void draw_lists_reset(DrawLists *dl, Arena *arena) {
+    dl->arena = arena;
+    for (uint32_t i = 0; i < dl->list_count; i++) {
+        DrawList *list = &dl->lists[i];
+        list->arena        = arena;
+        list->count        = 0;
+        list->uniform_size = 0;
+        list->cmds         = arena_push(arena, DrawCmd, list->capacity);
+        list->uniforms     = arena_alloc(arena, list->uniform_capacity, DRAW_UNIFORM_ALIGN);
+    }
+}
+
+DrawList *draw_lists_local(DrawLists *dl) {
+    uint32_t index = job_thread_index();
+    return &dl->lists[index < dl->list_count ? index : 0];
+}
+
+void draw_list_add(DrawList *list, const DrawCmd *cmd, const void *uniforms, uint32_t size) {
+    // Growing copies into a bigger arena block; the old one is reclaimed
+    // with the rest of the frame
+    if (list->count == list->capacity) {
+        DrawCmd *cmds = arena_push(list->arena, DrawCmd, list->capacity * 2);
+        memcpy(cmds, list->cmds, list->count * sizeof(DrawCmd));
+        list->cmds      = cmds;
+        list->capacity *= 2;
+    }
+    uint32_t offset = (list->uniform_size + DRAW_UNIFORM_ALIGN - 1) & ~(uint32_t)(DRAW_UNIFORM_ALIGN - 1);
+    if (offset + size > list->uniform_capacity) {
+        uint32_t capacity = list->uniform_capacity;
+        while (offset + size > capacity) capacity *= 2;
+        uint8_t *uniforms = arena_alloc(list->arena, capacity, DRAW_UNIFORM_ALIGN);
+        memcpy(uniforms, list->uniforms, list->uniform_size);
+        list->uniforms         = uniforms;
+        list->uniform_capacity = capacity;
+    }
+
+    DrawCmd *dst = &list->cmds[list->count++];
+    *dst = *cmd;
+    dst->uniform_offset = offset;
+    dst->uniform_size   = size;
+    if (size > 0) {
+        memcpy(list->uniforms + offset, uniforms, size);
+        list->uniform_size = offset + size;
+    }
+}
+
+// LSD radix sort on the key, a byte per pass. Stable, so refs that share a
+// key keep their merge order. Bytes where every key agrees are skipped,
+// which for typical keys leaves only the depth and a few state bytes.
+// Returns whichever buffer holds the result.
+static DrawRef *radix_sort(DrawRef *refs, DrawRef *tmp, uint32_t count) {
+    uint32_t hist[8][256] = {{0}};
+    for (uint32_t i = 0; i < count; i++) {
+        uint64_t key = refs[i].key;
+        for (int b = 0; b < 8; b++) hist[b][(key >> (b * 8)) & 0xFF]++;
+    }
+
+    DrawRef *src = refs;
+    DrawRef *dst = tmp;
+    for (int b = 0; b < 8; b++) {
+        uint32_t *h = hist[b];
+        if (h[(src[0].key >> (b * 8)) & 0xFF] == count) continue;
+
+        uint32_t sum = 0;
+        for (int v = 0; v < 256; v++) {
+            uint32_t c = h[v];
+            h[v] = sum;
+            sum += c;
+        }
+        for (uint32_t i = 0; i < count; i++) dst[h[(src[i].key >> (b * 8)) & 0xFF]++] = src[i];
+
+        DrawRef *t = src;
+        src = dst;
+        dst = t;
+    }
+    return src;
+}
+
+uint32_t draw_lists_submit(DrawLists *dl) {
+    uint32_t total = 0;
+    for (uint32_t i = 0; i < dl->list_count; i++) total += dl->lists[i].count;
+    dl->stats = (DrawStats){0};
+    if (total == 0) return 0;
+
+    DrawRef *merged = arena_push(dl->arena, DrawRef, total);
+    DrawRef *tmp    = arena_push(dl->arena, DrawRef, total);
+    uint32_t n      = 0;
+    for (uint32_t l = 0; l < dl->list_count; l++) {
+        const DrawList *list = &dl->lists[l];
+        for (uint32_t i = 0; i < list->count; i++) {
+            merged[n++] = (DrawRef){ .key = list->cmds[i].sort_key, .list = l, .index = i };
+        }
+    }
+    const DrawRef *refs = radix_sort(merged, tmp, total);
+
+    // Replay, only touching state that changes between neighbours
+    DrawStats         *stats    = &dl->stats;
+    uint32_t           pipeline = SG_INVALID_ID;
+    const sg_bindings *bindings = NULL;
+    for (uint32_t i = 0; i < total; i++) {
+        const DrawList *list = &dl->lists[refs[i].list];
+        const DrawCmd  *cmd  = &list->cmds[refs[i].index];
+        if (cmd->pipeline.id != pipeline) {
+            sg_apply_pipeline(cmd->pipeline);
+            pipeline = cmd->pipeline.id;
+            bindings = NULL;
+            stats->pipelines++;
+        } else {
+            stats->pipelines_elided++;
+        }
+        if (cmd->bindings != bindings) {
+            sg_apply_bindings(cmd->bindings);
+            bindings = cmd->bindings;
+            stats->bindings++;
+        } else {
+            stats->bindings_elided++;
+        }
+        if (cmd->uniform_size > 0) {
+            sg_apply_uniforms(cmd->uniform_slot, &(sg_range){ list->uniforms + cmd->uniform_offset, cmd->uniform_size });
+        }
+        sg_draw_ex(cmd->base_element, cmd->num_elements, cmd->num_instances, 0, cmd->base_instance);
+        stats->triangles += (uint32_t)(cmd->num_elements / 3 * cmd->num_instances);
+    }
+    stats->draws = total;
+    return total;
+}
@@ -0,0 +1,64 @@
+#include "frame_timing.h"
+#include "profile.h"
+#include "sokol_time.h"
+
+// Phases also go to the profiler under these names
+static const char *phase_names[FRAME_PHASE_COUNT] = {
+    [FRAME_PHASE_UPDATE] = "update",
+    [FRAME_PHASE_BUILD]  = "build",
+    [FRAME_PHASE_CULL]   = "cull",
+    [FRAME_PHASE_RECORD] = "record",
+    [FRAME_PHASE_SUBMIT] = "submit",
+};
+
+static struct {
+    uint64_t    startup_start;
+    uint64_t    first_frame;
+    uint64_t    frame_start;
+    uint64_t    phase_start;
+    FrameTiming current;
+    FrameTiming last;
+} timing;
+
+void frame_timing_startup(void) {
+    timing.startup_start = stm_now();
+    timing.first_frame   = 0;
+}
+
+void frame_timing_begin(void) {
+    timing.frame_start = stm_now();
+    timing.phase_start = timing.frame_start;
+    timing.current     = (FrameTiming){0};
+}
+
+void frame_timing_end_phase(FramePhase phase) {
+    uint64_t now = stm_now();
+    // Accumulate so a phase may be split around other work
+    timing.current.phase[phase] += stm_diff(now, timing.phase_start);
+    profile_record(phase_names[phase], timing.phase_start, now);
+    timing.phase_start = now;
+}
+
+void frame_timing_count(FrameCounter counter, uint32_t value) {
+    timing.current.counters[counter] += value;
+}
+
+void frame_timing_gpu(FrameGpuPass pass, uint64_t ns) {
+    timing.current.gpu[pass] = ns;
+}
+
+void frame_timing_end(void) {
+    uint64_t now = stm_now();
+    timing.current.total = stm_diff(now, timing.frame_start);
+    profile_record("frame", timing.frame_start, now);
+    timing.last          = timing.current;
+    if (timing.first_frame == 0) timing.first_frame = stm_since(timing.startup_start);
+}
+
+const FrameTiming *frame_timing_last(void) {
+    return &timing.last;
+}
+
+uint64_t frame_timing_first_frame(void) {
+    return timing.first_frame;
+}
@@ -0,0 +1,117 @@
+#include "frustum.h"
+
+#if defined(__SSE2__)
+    #include <emmintrin.h>
+#endif
+
+Frustum frustum_from_matrix(HMM_Mat4 m) {
+    // Gribb/Hartmann: each plane is the last row of the matrix plus or minus
+    // another row. Elements are [column][row].
+    HMM_Vec4 row[4];
+    for (int r = 0; r < 4; r++) {
+        row[r] = HMM_V4(m.Elements[0][r], m.Elements[1][r], m.Elements[2][r], m.Elements[3][r]);
+    }
+
+    Frustum f;
+    f.planes[FRUSTUM_LEFT]   = HMM_AddV4(row[3], row[0]);
+    f.planes[FRUSTUM_RIGHT]  = HMM_SubV4(row[3], row[0]);
+    f.planes[FRUSTUM_BOTTOM] = HMM_AddV4(row[3], row[1]);
+    f.planes[FRUSTUM_TOP]    = HMM_SubV4(row[3], row[1]);
+    f.planes[FRUSTUM_NEAR]   = HMM_AddV4(row[3], row[2]);
+    f.planes[FRUSTUM_FAR]    = HMM_SubV4(row[3], row[2]);
+
+    for (int p = 0; p < FRUSTUM_PLANE_COUNT; p++) {
+        float len = HMM_LenV3(f.planes[p].XYZ);
+        f.planes[p] = HMM_DivV4F(f.planes[p], len);
+    }
+    return f;
+}
+
+bool frustum_test_sphere(const Frustum *f, HMM_Vec3 center, float radius) {
+    for (int p = 0; p < FRUSTUM_PLANE_COUNT; p++) {
+        const HMM_Vec4 *pl = &f->planes[p];
+        if (HMM_DotV3(pl->XYZ, center) + pl->W < -radius) return false;
+    }
+    return true;
+}
+
+bool frustum_contains_sphere(const Frustum *f, HMM_Vec3 center, float radius) {
+    for (int p = 0; p < FRUSTUM_PLANE_COUNT; p++) {
+        const HMM_Vec4 *pl = &f->planes[p];
+        if (HMM_DotV3(pl->XYZ, center) + pl->W < radius) return false;
+    }
+    return true;
+}
+
+bool frustum_test_aabb(const Frustum *f, HMM_Vec3 min, HMM_Vec3 max) {
+    for (int p = 0; p < FRUSTUM_PLANE_COUNT; p++) {
+        const HMM_Vec4 *pl = &f->planes[p];
+        // The corner furthest along the plane normal
+        HMM_Vec3 v = HMM_V3(pl->X >= 0.0f ? max.X : min.X,
+                            pl->Y >= 0.0f ? max.Y : min.Y,
+                            pl->Z >= 0.0f ? max.Z : min.Z);
+        if (HMM_DotV3(pl->XYZ, v) + pl->W < 0.0f) return false;
+    }
+    return true;
+}
+
+FrustumClass frustum_classify_aabb(const Frustum *f, HMM_Vec3 min, HMM_Vec3 max) {
+    FrustumClass result = FRUSTUM_INSIDE;
+    for (int p = 0; p < FRUSTUM_PLANE_COUNT; p++) {
+        const HMM_Vec4 *pl = &f->planes[p];
+        // Corners furthest along and against the plane normal
+        HMM_Vec3 pos = HMM_V3(pl->X >= 0.0f ? max.X : min.X,
+                              pl->Y >= 0.0f ? max.Y : min.Y,
+                              pl->Z >= 0.0f ? max.Z : min.Z);
+        HMM_Vec3 neg = HMM_V3(pl->X >= 0.0f ? min.X : max.X,
+                              pl->Y >= 0.0f ? min.Y : max.Y,
+                              pl->Z >= 0.0f ? min.Z : max.Z);
+        if (HMM_DotV3(pl->XYZ, pos) + pl->W < 0.0f) return FRUSTUM_OUTSIDE;
+        if (HMM_DotV3(pl->XYZ, neg) + pl->W < 0.0f) result = FRUSTUM_INTERSECTS;
+    }
+    return result;
+}
+
+uint32_t frustum_cull_spheres(const Frustum *f,
+                              const float *x, const float *y, const float *z, const float *radius,
+                              uint32_t count, uint32_t *visible) {
+    uint32_t n = 0;
+    uint32_t i = 0;
+
+#if defined(__SSE2__)
+    __m128 px[FRUSTUM_PLANE_COUNT], py[FRUSTUM_PLANE_COUNT], pz[FRUSTUM_PLANE_COUNT], pw[FRUSTUM_PLANE_COUNT];
+    for (int p = 0; p < FRUSTUM_PLANE_COUNT; p++) {
+        px[p] = _mm_set1_ps(f->planes[p].X);
+        py[p] = _mm_set1_ps(f->planes[p].Y);
+        pz[p] = _mm_set1_ps(f->planes[p].Z);
+        pw[p] = _mm_set1_ps(f->planes[p].W);
+    }
+
+    for (; i + 4 <= count; i += 4) {
+        __m128 cx = _mm_loadu_ps(x + i);
+        __m128 cy = _mm_loadu_ps(y + i);
+        __m128 cz = _mm_loadu_ps(z + i);
+        __m128 nr = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(radius + i));
+
+        // Lanes stay set while the sphere is not fully outside any plane
+        __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+        for (int p = 0; p < FRUSTUM_PLANE_COUNT; p++) {
+            __m128 d = _mm_add_ps(_mm_add_ps(_mm_mul_ps(px[p], cx), _mm_mul_ps(py[p], cy)),
+                                  _mm_add_ps(_mm_mul_ps(pz[p], cz), pw[p]));
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(d, nr));
+        }
+
+        // Compact: append the index of every set lane
+        int mask = _mm_movemask_ps(inside);
+        while (mask) {
+            visible[n++] = i + (uint32_t)__builtin_ctz((unsigned)mask);
+            mask &= mask - 1;
+        }
+    }
+#endif
+
+    for (; i < count; i++) {
+        if (frustum_test_sphere(f, HMM_V3(x[i], y[i], z[i]), radius[i])) visible[n++] = i;
+    }
+    return n;
+}
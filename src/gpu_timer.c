@@ -0,0 +1,145 @@
+#include "gpu_timer.h"
+
+#if defined(SOKOL_GLCORE)
+#include "sokol_gfx.h"
+#define GL_GLEXT_PROTOTYPES
+#include <GL/gl.h>
+#include <string.h>
+
+// One set of begin/end timestamp queries per frame in flight
+typedef struct {
+    GLuint   queries[GPU_TIMER_MAX_PASSES][2];
+    uint32_t used;        // bit per pass with both queries issued
+    bool     pending;     // issued, not read back yet
+} QuerySet;
+
+static struct {
+    bool     enabled;
+    QuerySet sets[GPU_TIMER_FRAMES];
+    uint32_t frame;       // frames ended so far; frame % GPU_TIMER_FRAMES is recording
+    uint64_t results[GPU_TIMER_MAX_PASSES];
+} gpu;
+
+bool gpu_timer_setup(void) {
+    memset(&gpu, 0, sizeof(gpu));
+    if (sg_query_backend() != SG_BACKEND_GLCORE) return false;
+
+    // Timestamp queries are core since GL 3.3; a zero counter width means
+    // the implementation can't provide them
+    GLint bits = 0;
+    glGetQueryiv(GL_TIMESTAMP, GL_QUERY_COUNTER_BITS, &bits);
+    if (bits == 0) return false;
+
+    for (int f = 0; f < GPU_TIMER_FRAMES; f++) {
+        glGenQueries(GPU_TIMER_MAX_PASSES * 2, &gpu.sets[f].queries[0][0]);
+    }
+    gpu.enabled = true;
+    return true;
+}
+
+void gpu_timer_shutdown(void) {
+    if (!gpu.enabled) return;
+    for (int f = 0; f < GPU_TIMER_FRAMES; f++) {
+        glDeleteQueries(GPU_TIMER_MAX_PASSES * 2, &gpu.sets[f].queries[0][0]);
+    }
+    gpu.enabled = false;
+}
+
+static QuerySet *recording(void) {
+    return &gpu.sets[gpu.frame % GPU_TIMER_FRAMES];
+}
+
+void gpu_timer_begin(uint32_t pass) {
+    if (!gpu.enabled || pass >= GPU_TIMER_MAX_PASSES) return;
+    glQueryCounter(recording()->queries[pass][0], GL_TIMESTAMP);
+}
+
+void gpu_timer_end(uint32_t pass) {
+    if (!gpu.enabled || pass >= GPU_TIMER_MAX_PASSES) return;
+    QuerySet *set = recording();
+    glQueryCounter(set->queries[pass][1], GL_TIMESTAMP);
+    set->used |= 1u << pass;
+}
+
+// Read a set back if the GPU has finished it. Queries complete in order, so
+// the last end query being available means they all are.
+static bool read_back(QuerySet *set) {
+    GLuint last = 0;
+    for (int p = 0; p < GPU_TIMER_MAX_PASSES; p++) {
+        if (set->used & (1u << p)) last = set->queries[p][1];
+    }
+    GLint available = 0;
+    glGetQueryObjectiv(last, GL_QUERY_RESULT_AVAILABLE, &available);
+    if (!available) return false;
+
+    for (int p = 0; p < GPU_TIMER_MAX_PASSES; p++) {
+        if (!(set->used & (1u << p))) {
+            gpu.results[p] = 0;
+            continue;
+        }
+        GLuint64 begin = 0, end = 0;
+        glGetQueryObjectui64v(set->queries[p][0], GL_QUERY_RESULT, &begin);
+        glGetQueryObjectui64v(set->queries[p][1], GL_QUERY_RESULT, &end);
+        gpu.results[p] = end > begin ? end - begin : 0;
+    }
+    return true;
+}
+
+bool gpu_timer_end_frame(void) {
+    if (!gpu.enabled) return false;
+
+    QuerySet *set = recording();
+    set->pending  = set->used != 0;
+    gpu.frame++;
+
+    // Oldest first; queries complete in order, so stop at the first frame
+    // the GPU hasn't finished
+    bool     updated = false;
+    uint32_t first   = gpu.frame > GPU_TIMER_FRAMES ? gpu.frame - GPU_TIMER_FRAMES : 0;
+    for (uint32_t f = first; f < gpu.frame; f++) {
+        QuerySet *s = &gpu.sets[f % GPU_TIMER_FRAMES];
+        if (!s->pending) continue;
+        if (!read_back(s)) break;
+        s->pending = false;
+        updated    = true;
+    }
+
+    // The oldest set records next. If the GPU still hasn't finished it,
+    // that frame's result is dropped.
+    set          = recording();
+    set->pending = false;
+    set->used    = 0;
+    return updated;
+}
+
+uint64_t gpu_timer_result(uint32_t pass) {
+    return pass < GPU_TIMER_MAX_PASSES ? gpu.results[pass] : 0;
+}
+
+#else
+
+bool gpu_timer_setup(void) {
+    return false;
+}
+
+void gpu_timer_shutdown(void) {
+}
+
+void gpu_timer_begin(uint32_t pass) {
+    (void)pass;
+}
+
+void gpu_timer_end(uint32_t pass) {
+    (void)pass;
+}
+
+bool gpu_timer_end_frame(void) {
+    return false;
+}
+
+uint64_t gpu_timer_result(uint32_t pass) {
+    (void)pass;
+    return 0;
+}
+
+#endif
@@ -0,0 +1,233 @@
+#include "image.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Deflate's sliding window, and the hash table that finds match candidates
+// in it by their first three bytes
+#define DEFLATE_WINDOW    32768
+#define DEFLATE_MIN_MATCH 3
+#define DEFLATE_MAX_MATCH 258
+#define DEFLATE_HASH_BITS 15
+
+// LSB-first bit writer into a buffer sized for the worst case
+typedef struct {
+    uint8_t *out;
+    size_t   size;
+    uint32_t bits;
+    int      count;
+} BitWriter;
+
+static void put_bits(BitWriter *w, uint32_t value, int count) {
+    w->bits  |= value << w->count;
+    w->count += count;
+    while (w->count >= 8) {
+        w->out[w->size++] = (uint8_t)w->bits;
+        w->bits  >>= 8;
+        w->count  -= 8;
+    }
+}
+
+// Huffman codes go out most significant bit first
+static void put_code(BitWriter *w, uint32_t code, int count) {
+    uint32_t reversed = 0;
+    for (int i = 0; i < count; i++) reversed |= ((code >> i) & 1) << (count - 1 - i);
+    put_bits(w, reversed, count);
+}
+
+// Fixed literal/length code (RFC 1951 3.2.6)
+static void put_literal(BitWriter *w, uint32_t symbol) {
+    if (symbol < 144) {
+        put_code(w, 0x30 + symbol, 8);
+    } else if (symbol < 256) {
+        put_code(w, 0x190 + symbol - 144, 9);
+    } else if (symbol < 280) {
+        put_code(w, symbol - 256, 7);
+    } else {
+        put_code(w, 0xC0 + symbol - 280, 8);
+    }
+}
+
+static const uint16_t length_base[29] = {
+    3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+    35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258,
+};
+static const uint8_t length_extra[29] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0,
+};
+static const uint16_t dist_base[30] = {
+    1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+    257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577,
+};
+static const uint8_t dist_extra[30] = {
+    0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13,
+};
+
+static void put_match(BitWriter *w, uint32_t length, uint32_t dist) {
+    int l = 28;
+    while (length_base[l] > length) l--;
+    put_literal(w, 257 + (uint32_t)l);
+    put_bits(w, length - length_base[l], length_extra[l]);
+
+    int d = 29;
+    while (dist_base[d] > dist) d--;
+    put_code(w, (uint32_t)d, 5);
+    put_bits(w, dist - dist_base[d], dist_extra[d]);
+}
+
+static uint32_t hash3(const uint8_t *p) {
+    uint32_t v = (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16;
+    return (v * 2654435761u) >> (32 - DEFLATE_HASH_BITS);
+}
+
+// One fixed-Huffman block with greedy matching against the last position
+// seen for each hash. Returns the compressed size, or 0 if out of memory.
+static size_t deflate_fixed(const uint8_t *in, size_t size, uint8_t *out) {
+    uint32_t *head = malloc(sizeof(uint32_t) << DEFLATE_HASH_BITS);
+    if (!head) return 0;
+    memset(head, 0xFF, sizeof(uint32_t) << DEFLATE_HASH_BITS);
+
+    BitWriter w = { .out = out };
+    put_bits(&w, 1, 1);   // final block
+    put_bits(&w, 1, 2);   // fixed codes
+    size_t i = 0;
+    while (i < size) {
+        uint32_t length = 0, dist = 0;
+        if (i + DEFLATE_MIN_MATCH <= size) {
+            uint32_t h    = hash3(in + i);
+            uint32_t prev = head[h];
+            head[h] = (uint32_t)i;
+            if (prev != UINT32_MAX && i - prev <= DEFLATE_WINDOW) {
+                size_t max = size - i < DEFLATE_MAX_MATCH ? size - i : DEFLATE_MAX_MATCH;
+                while (length < max && in[prev + length] == in[i + length]) length++;
+                dist = (uint32_t)(i - prev);
+            }
+        }
+        if (length >= DEFLATE_MIN_MATCH) {
+            put_match(&w, length, dist);
+            // Keep the skipped positions findable
+            for (size_t k = i + 1; k < i + length && k + DEFLATE_MIN_MATCH <= size; k++) {
+                head[hash3(in + k)] = (uint32_t)k;
+            }
+            i += length;
+        } else {
+            put_literal(&w, in[i++]);
+        }
+    }
+    put_literal(&w, 256);   // end of block
+    if (w.count > 0) put_bits(&w, 0, 8 - w.count);
+    free(head);
+    return w.size;
+}
+
+static uint32_t crc32_update(uint32_t crc, const uint8_t *p, size_t size) {
+    static uint32_t table[256];
+    if (!table[1]) {
+        for (uint32_t n = 0; n < 256; n++) {
+            uint32_t c = n;
+            for (int k = 0; k < 8; k++) c = c & 1 ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            table[n] = c;
+        }
+    }
+    crc = ~crc;
+    for (size_t i = 0; i < size; i++) crc = table[(crc ^ p[i]) & 0xFF] ^ (crc >> 8);
+    return ~crc;
+}
+
+static void put_be32(uint8_t *p, uint32_t v) {
+    p[0] = (uint8_t)(v >> 24);
+    p[1] = (uint8_t)(v >> 16);
+    p[2] = (uint8_t)(v >> 8);
+    p[3] = (uint8_t)v;
+}
+
+// Length, type, data and CRC of one PNG chunk
+static bool write_chunk(FILE *f, const char *type, const uint8_t *data, size_t size) {
+    uint8_t header[8], crc[4];
+    put_be32(header, (uint32_t)size);
+    memcpy(header + 4, type, 4);
+    put_be32(crc, crc32_update(crc32_update(0, header + 4, 4), data, size));
+    return fwrite(header, 1, 8, f) == 8 && (size == 0 || fwrite(data, 1, size, f) == size) &&
+           fwrite(crc, 1, 4, f) == 4;
+}
+
+bool image_write_png(const char *path, const uint32_t *pixels, uint32_t width, uint32_t height,
+                     uint32_t stride) {
+    // Filter type 0 (none) per row, then the pixel bytes
+    size_t   row      = 1 + (size_t)width * 4;
+    size_t   raw_size = row * height;
+    uint8_t *raw      = malloc(raw_size);
+    // zlib header, worst case 9 bits per byte, Adler-32
+    uint8_t *z        = malloc(2 + raw_size + raw_size / 8 + 64 + 4);
+    if (!raw || !z) {
+        free(raw);
+        free(z);
+        return false;
+    }
+    for (uint32_t y = 0; y < height; y++) {
+        raw[y * row] = 0;
+        for (uint32_t x = 0; x < width; x++) {
+            uint32_t c = pixels[(size_t)y * stride + x];
+            uint8_t *p = raw + y * row + 1 + x * 4;
+            p[0] = (uint8_t)c;
+            p[1] = (uint8_t)(c >> 8);
+            p[2] = (uint8_t)(c >> 16);
+            p[3] = (uint8_t)(c >> 24);
+        }
+    }
+
+    z[0] = 0x78;
+    z[1] = 0x01;
+    size_t size = deflate_fixed(raw, raw_size, z + 2);
+    bool   ok   = size > 0;
+    if (ok) {
+        uint32_t a = 1, b = 0;
+        for (size_t i = 0; i < raw_size; i++) {
+            a = (a + raw[i]) % 65521;
+            b = (b + a) % 65521;
+        }
+        put_be32(z + 2 + size, b << 16 | a);
+        size += 6;
+    }
+    free(raw);
+
+    FILE *f = ok ? fopen(path, "wb") : NULL;
+    if (f) {
+        static const uint8_t signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+        uint8_t ihdr[13];
+        put_be32(ihdr, width);
+        put_be32(ihdr + 4, height);
+        ihdr[8]  = 8;   // bits per channel
+        ihdr[9]  = 6;   // RGBA
+        ihdr[10] = 0;   // deflate
+        ihdr[11] = 0;   // adaptive filtering
+        ihdr[12] = 0;   // not interlaced
+        ok = fwrite(signature, 1, 8, f) == 8 && write_chunk(f, "IHDR", ihdr, sizeof(ihdr)) &&
+             write_chunk(f, "IDAT", z, size) && write_chunk(f, "IEND", NULL, 0);
+        ok = fclose(f) == 0 && ok;
+    } else {
+        ok = false;
+    }
+    free(z);
+    return ok;
+}
+
+ImageDiff image_compare(const uint32_t *a, uint32_t a_stride, const uint32_t *b, uint32_t b_stride,
+                        uint32_t width, uint32_t height, uint32_t tolerance) {
+    ImageDiff diff = {0};
+    for (uint32_t y = 0; y < height; y++) {
+        for (uint32_t x = 0; x < width; x++) {
+            uint32_t ca = a[(size_t)y * a_stride + x];
+            uint32_t cb = b[(size_t)y * b_stride + x];
+            uint32_t worst = 0;
+            for (int s = 0; s < 32; s += 8) {
+                int d = (int)((ca >> s) & 0xFF) - (int)((cb >> s) & 0xFF);
+                uint32_t delta = (uint32_t)(d < 0 ? -d : d);
+                if (delta > worst) worst = delta;
+            }
+            if (worst > diff.max_delta) diff.max_delta = worst;
+            if (worst > tolerance) diff.differing++;
+        }
+    }
+    return diff;
+}
@@ -0,0 +1,257 @@
+#include "job.h"
+#include "profile.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#define JOB_DEQUE_MASK (JOB_DEQUE_SIZE - 1)
+
+// Failed find_job() rounds a worker spins through before going to sleep
+#define JOB_SPIN_ROUNDS 64
+
+typedef struct {
+    JobFunc      func;
+    JobRangeFunc range_func;
+    void        *data;
+    JobCounter  *counter;
+    uint32_t     begin;
+    uint32_t     end;
+} Job;
+
+// Chase-Lev work-stealing deque (Le et al., "Correct and Efficient
+// Work-Stealing for Weak Memory Models"). The owner pushes and pops at the
+// bottom, other threads steal from the top.
+typedef struct {
+    _Alignas(64) atomic_llong top;
+    _Alignas(64) atomic_llong bottom;
+    Job jobs[JOB_DEQUE_SIZE];
+} JobDeque;
+
+static bool deque_push(JobDeque *d, const Job *job) {
+    long long b = atomic_load_explicit(&d->bottom, memory_order_relaxed);
+    long long t = atomic_load_explicit(&d->top, memory_order_acquire);
+    if (b - t >= JOB_DEQUE_SIZE) return false;
+    d->jobs[b & JOB_DEQUE_MASK] = *job;
+    atomic_store_explicit(&d->bottom, b + 1, memory_order_release);
+    return true;
+}
+
+static bool deque_pop(JobDeque *d, Job *out) {
+    long long b = atomic_load_explicit(&d->bottom, memory_order_relaxed) - 1;
+    atomic_store_explicit(&d->bottom, b, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    long long t = atomic_load_explicit(&d->top, memory_order_relaxed);
+
+    if (t > b) {
+        // Empty
+        atomic_store_explicit(&d->bottom, b + 1, memory_order_relaxed);
+        return false;
+    }
+    *out = d->jobs[b & JOB_DEQUE_MASK];
+    if (t < b) return true;
+
+    // Last job: race thieves for it
+    bool won = atomic_compare_exchange_strong_explicit(&d->top, &t, t + 1,
+                                                       memory_order_seq_cst, memory_order_relaxed);
+    atomic_store_explicit(&d->bottom, b + 1, memory_order_relaxed);
+    return won;
+}
+
+static bool deque_steal(JobDeque *d, Job *out) {
+    long long t = atomic_load_explicit(&d->top, memory_order_acquire);
+    atomic_thread_fence(memory_order_seq_cst);
+    long long b = atomic_load_explicit(&d->bottom, memory_order_acquire);
+    if (t >= b) return false;
+
+    // The slot can't be reused before top moves past it, and if another
+    // thief got there first the CAS fails and the copy is dropped
+    *out = d->jobs[t & JOB_DEQUE_MASK];
+    return atomic_compare_exchange_strong_explicit(&d->top, &t, t + 1,
+                                                   memory_order_seq_cst, memory_order_relaxed);
+}
+
+static struct {
+    JobDeque   *deques;          // one per thread, [0] is the init thread's
+    pthread_t   threads[JOB_MAX_WORKERS];
+    uint32_t    thread_count;
+    atomic_bool quit;
+
+    // Sleeping workers are woken when jobs are queued
+    atomic_uint     queued;
+    atomic_uint     sleepers;
+    pthread_mutex_t mutex;
+    pthread_cond_t  wake;
+} jobs;
+
+static _Thread_local uint32_t thread_index = UINT32_MAX;
+
+static void execute(const Job *job) {
+    if (job->range_func) {
+        job->range_func(job->data, job->begin, job->end);
+    } else {
+        job->func(job->data);
+    }
+    if (job->counter) atomic_fetch_sub_explicit(&job->counter->pending, 1, memory_order_release);
+}
+
+// Own deque first, then steal, starting at a different victim each call
+static bool find_job(uint32_t self, uint32_t *victim, Job *out) {
+    if (deque_pop(&jobs.deques[self], out)) return true;
+    for (uint32_t i = 0; i < jobs.thread_count; i++) {
+        uint32_t v = (*victim + i) % jobs.thread_count;
+        if (v != self && deque_steal(&jobs.deques[v], out)) {
+            *victim = v;
+            return true;
+        }
+    }
+    *victim = (*victim + 1) % jobs.thread_count;
+    return false;
+}
+
+static bool run_one(uint32_t self, uint32_t *victim) {
+    Job job;
+    if (!find_job(self, victim, &job)) return false;
+    atomic_fetch_sub_explicit(&jobs.queued, 1, memory_order_relaxed);
+    execute(&job);
+    return true;
+}
+
+static void *worker_main(void *arg) {
+    thread_index    = (uint32_t)(uintptr_t)arg;
+    uint32_t victim = 0;
+    uint32_t idle   = 0;
+    profile_thread_name("worker");
+
+    while (!atomic_load(&jobs.quit)) {
+        if (run_one(thread_index, &victim)) {
+            idle = 0;
+            continue;
+        }
+        if (++idle < JOB_SPIN_ROUNDS) {
+            sched_yield();
+            continue;
+        }
+
+        // Sleep until job_run() or shutdown. queued and sleepers are both
+        // seq_cst, so either we see the new job or the pusher sees us.
+        pthread_mutex_lock(&jobs.mutex);
+        atomic_fetch_add(&jobs.sleepers, 1);
+        while (atomic_load(&jobs.queued) == 0 && !atomic_load(&jobs.quit)) {
+            pthread_cond_wait(&jobs.wake, &jobs.mutex);
+        }
+        atomic_fetch_sub(&jobs.sleepers, 1);
+        pthread_mutex_unlock(&jobs.mutex);
+        idle = 0;
+    }
+    profile_thread_release();
+    return NULL;
+}
+
+bool job_system_init(uint32_t worker_count) {
+    if (worker_count == 0) {
+        long cores   = sysconf(_SC_NPROCESSORS_ONLN);
+        worker_count = cores > 1 ? (uint32_t)cores - 1 : 0;
+    }
+    if (worker_count > JOB_MAX_WORKERS) worker_count = JOB_MAX_WORKERS;
+
+    jobs.thread_count = worker_count + 1;
+    jobs.deques       = aligned_alloc(64, jobs.thread_count * sizeof(JobDeque));
+    if (!jobs.deques) return false;
+    for (uint32_t i = 0; i < jobs.thread_count; i++) {
+        atomic_init(&jobs.deques[i].top, 0);
+        atomic_init(&jobs.deques[i].bottom, 0);
+    }
+    atomic_init(&jobs.quit, false);
+    atomic_init(&jobs.queued, 0);
+    atomic_init(&jobs.sleepers, 0);
+    pthread_mutex_init(&jobs.mutex, NULL);
+    pthread_cond_init(&jobs.wake, NULL);
+    thread_index = 0;
+
+    for (uint32_t i = 1; i < jobs.thread_count; i++) {
+        if (pthread_create(&jobs.threads[i - 1], NULL, worker_main, (void *)(uintptr_t)i) != 0) {
+            // Run with the workers we got
+            jobs.thread_count = i;
+            break;
+        }
+    }
+    return true;
+}
+
+void job_system_shutdown(void) {
+    if (!jobs.deques) return;
+
+    // Drain what's left on this thread, then stop the workers
+    uint32_t victim = 0;
+    while (atomic_load(&jobs.queued) > 0) {
+        if (!run_one(0, &victim)) sched_yield();
+    }
+    pthread_mutex_lock(&jobs.mutex);
+    atomic_store(&jobs.quit, true);
+    pthread_cond_broadcast(&jobs.wake);
+    pthread_mutex_unlock(&jobs.mutex);
+    for (uint32_t i = 1; i < jobs.thread_count; i++) pthread_join(jobs.threads[i - 1], NULL);
+
+    pthread_mutex_destroy(&jobs.mutex);
+    pthread_cond_destroy(&jobs.wake);
+    free(jobs.deques);
+    jobs.deques       = NULL;
+    jobs.thread_count = 0;
+    thread_index      = UINT32_MAX;
+}
+
+uint32_t job_thread_count(void) {
+    return jobs.thread_count > 0 ? jobs.thread_count : 1;
+}
+
+uint32_t job_thread_index(void) {
+    return thread_index;
+}
+
+static void submit(const Job *job) {
+    if (job->counter) atomic_fetch_add_explicit(&job->counter->pending, 1, memory_order_relaxed);
+
+    if (!jobs.deques || thread_index >= jobs.thread_count) {
+        execute(job);
+        return;
+    }
+    // Count before pushing so a thief can never take queued below zero
+    atomic_fetch_add(&jobs.queued, 1);
+    if (!deque_push(&jobs.deques[thread_index], job)) {
+        atomic_fetch_sub(&jobs.queued, 1);
+        execute(job);
+        return;
+    }
+    if (atomic_load(&jobs.sleepers) > 0) {
+        pthread_mutex_lock(&jobs.mutex);
+        pthread_cond_signal(&jobs.wake);
+        pthread_mutex_unlock(&jobs.mutex);
+    }
+}
+
+void job_run(JobFunc func, void *data, JobCounter *counter) {
+    submit(&(Job){ .func = func, .data = data, .counter = counter });
+}
+
+void job_wait(JobCounter *counter) {
+    uint32_t victim = thread_index;
+    while (atomic_load_explicit(&counter->pending, memory_order_acquire) > 0) {
+        if (thread_index >= jobs.thread_count || !run_one(thread_index, &victim)) sched_yield();
+    }
+}
+
+void job_parallel_for(uint32_t count, uint32_t grain, JobRangeFunc func, void *data) {
+    if (grain == 0) grain = 1;
+    if (count <= grain || job_thread_count() == 1) {
+        if (count > 0) func(data, 0, count);
+        return;
+    }
+
+    JobCounter counter = {0};
+    for (uint32_t begin = 0; begin < count; begin += grain) {
+        uint32_t end = count - begin > grain ? begin + grain : count;
+        submit(&(Job){ .range_func = func, .data = data, .counter = &counter, .begin = begin, .end = end });
+    }
+    job_wait(&counter);
+}
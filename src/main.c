@@ -1,104 +1,738 @@
 #include "camera.h"
 #include "input.h"
+#include "frame_timing.h"
+#include "texture.h"
+#include "mesh.h"
+#include "mesh_format.h"
+#include "scene.h"
+#include "frustum.h"
+#include "bvh.h"
+#include "job.h"
+#include "draw_list.h"
+#include "arena.h"
+#include "pool.h"
+#include "profile.h"
+#include "gpu_timer.h"
+#include "stats.h"
+#include "raster.h"
+#include "image.h"
+#include "occlusion.h"
+#include "meshlet.h"
+#include "stream.h"
+#include "transform.h"
 #include "HandmadeMath.h"
 
-#define SOKOL_IMPL
-#define SOKOL_GLCORE
+#if defined(SOKOL_DUMMY_BACKEND)
+    // Headless build (make bench): no window or GL context. The sokol_app and
+    // sokol_glue functions used below are provided by the bench harness.
+    #define SOKOL_GFX_IMPL
+    #define SOKOL_LOG_IMPL
+    #define SOKOL_TIME_IMPL
+    #define SOKOL_FETCH_IMPL
+    #define SOKOL_ARGS_IMPL
+#else
+    // SOKOL_GLCORE comes from the Makefile, so other modules see the backend
+    #define SOKOL_IMPL
+#endif
 #define STB_IMAGE_IMPLEMENTATION
 #include "sokol_app.h"
 #include "sokol_gfx.h"
 #include "sokol_log.h"
 #include "sokol_glue.h"
+#include "sokol_time.h"
+#include "sokol_fetch.h"
+#include "sokol_args.h"
 #include "stb_image.h"
 #include "pyramid.glsl.h"
 
 
+#include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
+// Distance between neighbouring pyramids in instanced mode
+#define INSTANCE_SPACING 1.5f
+
+// Spin rate of the instanced pyramids, radians per second
+#define INSTANCE_SPIN_SPEED 1.0f
+
+// Entities per job for the transform update and the visible-list gather
+#define JOB_GRAIN 4096
+
+// BVH subtrees per thread the frustum cull is split into
+#define CULL_SPLITS_PER_THREAD 4
+
+// occluders=N places N large pyramids this far apart in a row across the
+// grid, this much bigger than the rest
+#define OCCLUDER_SPACING 7.0f
+#define OCCLUDER_SCALE   6.0f
+#define OCCLUDER_Z       (-6.0f)
+
+// Size of the CPU depth buffer occluders are rasterized into
+#define OCCLUSION_WIDTH  256
+#define OCCLUSION_HEIGHT 192
+
+// lod_error=PIXELS: how far a level of detail may stray from the full mesh
+// on screen before a finer one is drawn
+#define LOD_DEFAULT_ERROR_PIXELS 1.0f
+
+// What every entity draws unless mesh= names another .mesh file
+#define DEFAULT_MESH_PATH "data/meshes/pyramid.mesh"
+
+// Resource pool sizes
+#define MAX_MESHES    64
+#define MAX_MATERIALS 64
+
+// Materials differ only in how the texture is filtered. The grid alternates
+// them in a checkerboard.
+typedef enum {
+    MATERIAL_SMOOTH,
+    MATERIAL_PIXELATED,
+    MATERIAL_COUNT,
+} Material;
+
+// Visible entities per draw recording job, and per batched MVP multiply
+// within one
+#define RECORD_GRAIN 1024
+#define RECORD_BATCH 64
+
+// Window title; the stats overlay is appended to it
+#define WINDOW_TITLE "3d engine"
+
+// Starting size of each per-frame arena. They grow to the peak a frame
+// needs within the first couple of frames.
+#define FRAME_ARENA_SIZE (1u << 20)
+
+// Starting size of the meshlet index stream. It grows the same way, with
+// headroom so a camera turn doesn't replace its buffers every frame.
+#define MESHLET_STREAM_SIZE (1u << 20)
+
+// A record job's share of meshlet_stream: room for its entities' selected
+// LODs, how much of that it wrote, and the draws that index it
+typedef struct {
+    uint8_t  *indices;
+    size_t    size;       // bytes reserved
+    uint32_t  first;      // element offset of indices in the stream
+    uint32_t  written;    // elements
+    uint32_t  culled;
+    DrawList *list;
+    uint32_t  cmd_first;
+    uint32_t  cmd_end;
+} MeshletBlock;
+
 static struct {
     sg_pipeline    pip;
-    sg_bindings    bind;
     sg_pass_action pass_action;
-    sg_image       img;
-    sg_view        img_view;
-    sg_sampler     smp;
+    Texture        texture;
+
+    // Entities refer to meshes and materials by pool handle. A material is
+    // its bindings, so draws can be sorted and grouped by them.
+    Pool           meshes;      // Mesh
+    Pool           materials;   // sg_bindings
+    uint32_t       pyramid;     // loaded from mesh_path (mesh=)
+    const char    *mesh_path;
+    uint32_t       material_handles[MATERIAL_COUNT];
+    sg_sampler     samplers[MATERIAL_COUNT];
+
+    // instances=N on the command line lays out a spinning grid of N
+    // pyramids. By default their world matrices are streamed into vertex
+    // buffer 1 and drawn with one sg_draw(); instancing=off draws each one
+    // separately.
+    bool           grid;
+    bool           instanced;
+    sg_buffer      instance_buffer;
+
+    // Separate draws pull their MVP from a per-frame storage buffer, indexed
+    // by base instance, where the backend supports both. objects holds this
+    // frame's MVPs in visible-list order. pulled_force records pulled draws
+    // without either feature, for the bench's capture on the dummy backend;
+    // they get no GPU resources and are never submitted.
+    bool           pulled;
+    bool           pulled_force;
+    sg_buffer      object_buffer;
+    sg_view        object_view;
+    sg_buffer      object_index_buffer;
+    HMM_Mat4      *objects;
+
+    // Instanced mode draws the visible entities sharing a material and LOD
+    // as one run of the instance buffer. Indexed by packed material index
+    // times MESH_MAX_LODS plus LOD.
+    uint32_t       run_first[MAX_MATERIALS * MESH_MAX_LODS];
+    uint32_t       run_count[MAX_MATERIALS * MESH_MAX_LODS];
+
+    // Draw commands, recorded per thread and replayed in SUBMIT
+    DrawLists      draw_lists;
+
+    Scene      scene;
+    Bvh        bvh;
+    float      time;
+
+    // Scratch for everything below that only lives for one frame. Double
+    // buffered, so jobs still reading last frame's data stay valid.
+    FrameArena frame_arena;
+
+    // Frustum culling output: indices of visible entities, and their world
+    // matrices gathered for upload in instanced mode
+    uint32_t  *visible;
+    uint32_t   visible_count;
+    uint32_t  *visible_tmp;
+    HMM_Mat4  *visible_world;
+
+    // Entities whose bounds changed this frame, for the incremental BVH refit.
+    // Jobs write theirs at their own offset, with a count per job.
+    uint32_t  *moved;
+    uint32_t   moved_count;
+    uint32_t  *moved_counts;
+
+    // The frustum cull runs one job per subtree, each writing its visible
+    // entities at the subtree's offset in visible
+    BvhSubtree *cull_splits;
+    uint32_t   *cull_counts;
+    uint32_t    cull_split_count;
+
+    // Occlusion culling: occluder_count entities from occluder_first are
+    // rasterized into a CPU depth pyramid each frame, and frustum-visible
+    // entities whose bounds are behind it are dropped. occlusion=off keeps
+    // the occluders but skips the test. occluded_counts has one per split.
+    bool       occlusion_enabled;
+    Occlusion  occlusion;
+    MeshData   occluder_mesh;
+    uint32_t   occluder_first;
+    uint32_t   occluder_count;
+    uint32_t  *occluded_counts;
+
+    // Screen-space error allowed before a finer LOD is drawn (lod_error=)
+    float      lod_threshold;
+
+    // meshlets=on culls separate draws per meshlet while recording. An entity
+    // that loses enough of them (see meshlet_cull()) draws the survivors'
+    // index runs from meshlet_stream, through its material's copy in
+    // meshlet_bindings (indexed like the pool); the rest draw as usual. Stream
+    // isn't thread-safe, so each record job gets a block of it up front,
+    // room for its entities at their selected LODs. The blocks are packed
+    // before upload, so only the surviving indices are sent.
+    bool          meshlets;
+    Stream        meshlet_stream;
+    uint32_t      meshlet_index_size;
+    MeshletBlock *meshlet_blocks;
+    sg_bindings   meshlet_bindings[MAX_MATERIALS];
 
     Camera     camera;
     InputState input;
+
+    // capture=file.png captures frame capture_frame (capture_frame=N, default 0)
+    uint32_t   frame_index;
+    uint32_t   capture_frame;
+
+    // Set once init() has everything frame() needs. If it fails the app
+    // quits, and any frame sokol_app still runs meanwhile does nothing.
+    bool       ready;
 } state;
 
+// sokol-shdc emits no shader desc for the dummy backend, so borrow the GL one
+// there; sokol_gfx still validates the resource layout against it.
+static const sg_shader_desc *shader_desc(const sg_shader_desc *(*get_desc)(sg_backend)) {
+    const sg_shader_desc *desc = get_desc(sg_query_backend());
+#if defined(SOKOL_DUMMY_BACKEND)
+    if (!desc) desc = get_desc(SG_BACKEND_GLCORE);
+#endif
+    return desc;
+}
+
+// Lay count pyramids out on a square grid in the XZ plane, in front of the camera
+static void add_pyramid_grid(Scene *scene, uint32_t count) {
+    uint32_t side = (uint32_t)ceilf(sqrtf((float)count));
+    for (uint32_t i = 0; i < count; i++) {
+        float x = ((float)(i % side) - (float)(side / 2)) * INSTANCE_SPACING;
+        float z = -(float)(i / side) * INSTANCE_SPACING;
+        uint32_t material = state.material_handles[(i % side + i / side) % MATERIAL_COUNT];
+        scene_add(scene, HMM_V3(x, 0.0f, z), HMM_Q(0.0f, 0.0f, 0.0f, 1.0f), HMM_V3(1.0f, 1.0f, 1.0f),
+                  state.pyramid, material);
+    }
+}
+
+// A row of large pyramids across the view, centred on the grid's x axis
+static void add_occluders(Scene *scene, uint32_t count) {
+    state.occluder_first = scene->count;
+    state.occluder_count = count;
+    for (uint32_t i = 0; i < count; i++) {
+        float x = ((float)i - (float)(count - 1) * 0.5f) * OCCLUDER_SPACING;
+        scene_add(scene, HMM_V3(x, OCCLUDER_SCALE * 0.5f - 0.5f, OCCLUDER_Z), HMM_Q(0.0f, 0.0f, 0.0f, 1.0f),
+                  HMM_V3(OCCLUDER_SCALE, OCCLUDER_SCALE, OCCLUDER_SCALE), state.pyramid,
+                  state.material_handles[MATERIAL_SMOOTH]);
+    }
+}
+
+static void set_mesh_bounds(Scene *scene) {
+    for (uint32_t i = 0; i < scene->count; i++) {
+        const Mesh *mesh = pool_get(&state.meshes, scene->mesh[i]);
+        if (mesh) scene_set_bounds(scene, i, mesh->sphere_center, mesh->sphere_radius);
+    }
+}
+
+// Same rotation about Y for every entity
+static void spin_entities(Scene *scene, float angle) {
+    float s = sinf(angle * 0.5f);
+    float c = cosf(angle * 0.5f);
+    for (uint32_t i = 0; i < scene->count; i++) {
+        scene->rot_x[i] = 0.0f;
+        scene->rot_y[i] = s;
+        scene->rot_z[i] = 0.0f;
+        scene->rot_w[i] = c;
+    }
+}
+
+static void update_transforms_job(void *data, uint32_t begin, uint32_t end) {
+    (void)data;
+    profile_begin("transforms job");
+    state.moved_counts[begin / JOB_GRAIN] =
+        scene_update_transforms_range(&state.scene, begin, end, state.moved + begin);
+    profile_end();
+}
+
+typedef struct {
+    Frustum  frustum;
+    HMM_Vec3 eye;
+    float    pixels_per_unit;   // on screen, for something 1 unit from the eye
+} CullParams;
+
+// Pick each visible entity's LOD from how large its mesh's simplification
+// error would appear, measured at the nearest point of its bounding sphere
+static void select_lods(const CullParams *params, const uint32_t *visible, uint32_t count) {
+    Scene *s = &state.scene;
+    for (uint32_t k = 0; k < count; k++) {
+        uint32_t    e    = visible[k];
+        const Mesh *mesh = pool_get(&state.meshes, s->mesh[e]);
+        if (!mesh || mesh->lod_count <= 1 || mesh->sphere_radius <= 0.0f) continue;
+        HMM_Vec3 c        = HMM_V3(s->sphere_x[e], s->sphere_y[e], s->sphere_z[e]);
+        float    distance = HMM_LenV3(HMM_SubV3(c, params->eye)) - s->sphere_radius[e];
+        if (distance < state.camera.near_plane) distance = state.camera.near_plane;
+        float scale = s->sphere_radius[e] / mesh->sphere_radius;
+        s->lod[e] = (uint8_t)mesh_select_lod(mesh, s->lod[e], params->pixels_per_unit * scale / distance,
+                                             state.lod_threshold);
+    }
+}
+
+static void cull_job(void *data, uint32_t begin, uint32_t end) {
+    const CullParams *params  = data;
+    const Frustum    *frustum = &params->frustum;
+    profile_begin("cull job");
+    for (uint32_t i = begin; i < end; i++) {
+        const BvhSubtree *split = &state.cull_splits[i];
+        uint32_t         *visible = state.visible + split->first;
+        uint32_t          count   = bvh_cull_frustum_subtree(&state.bvh, &state.scene, frustum, split->node,
+                                                             visible);
+        if (state.occlusion_enabled) {
+            // Test the box around each world bounding sphere
+            const Scene *s    = &state.scene;
+            uint32_t     kept = 0;
+            for (uint32_t k = 0; k < count; k++) {
+                uint32_t e = visible[k];
+                HMM_Vec3 c = HMM_V3(s->sphere_x[e], s->sphere_y[e], s->sphere_z[e]);
+                HMM_Vec3 r = HMM_V3(s->sphere_radius[e], s->sphere_radius[e], s->sphere_radius[e]);
+                if (occlusion_test_box(&state.occlusion, HMM_SubV3(c, r), HMM_AddV3(c, r))) visible[kept++] = e;
+            }
+            state.occluded_counts[i] = count - kept;
+            count = kept;
+        }
+        select_lods(params, visible, count);
+        state.cull_counts[i] = count;
+    }
+    profile_end();
+}
+
+static void gather_visible_job(void *data, uint32_t begin, uint32_t end) {
+    (void)data;
+    for (uint32_t i = begin; i < end; i++) state.visible_world[i] = state.scene.world[state.visible[i]];
+}
+
+// Stable counting sort of the visible list by packed material index and
+// LOD, recording where each run starts. Entities whose material has been
+// released are dropped.
+static void sort_visible_by_run(void) {
+    const Pool     *materials = &state.materials;
+    const uint32_t *material  = state.scene.material;
+    const uint8_t  *lod       = state.scene.lod;
+    uint32_t        runs      = materials->count * MESH_MAX_LODS;
+    uint32_t        offset[MAX_MATERIALS * MESH_MAX_LODS];
+    memset(state.run_count, 0, sizeof(state.run_count));
+    for (uint32_t i = 0; i < state.visible_count; i++) {
+        uint32_t e = state.visible[i];
+        uint32_t m = pool_index(materials, material[e]);
+        if (m != UINT32_MAX) state.run_count[m * MESH_MAX_LODS + lod[e]]++;
+    }
+
+    uint32_t sum = 0;
+    for (uint32_t r = 0; r < runs; r++) {
+        state.run_first[r] = offset[r] = sum;
+        sum += state.run_count[r];
+    }
+    for (uint32_t i = 0; i < state.visible_count; i++) {
+        uint32_t e = state.visible[i];
+        uint32_t m = pool_index(materials, material[e]);
+        if (m != UINT32_MAX) state.visible_tmp[offset[m * MESH_MAX_LODS + lod[e]]++] = e;
+    }
+
+    uint32_t *t         = state.visible;
+    state.visible       = state.visible_tmp;
+    state.visible_tmp   = t;
+    state.visible_count = sum;
+}
+
+typedef struct {
+    HMM_Mat4 view_proj;
+    Frustum  frustum;
+    HMM_Vec3 eye;
+    HMM_Vec3 forward;
+} RecordParams;
+
+// Record one draw per visible entity into this thread's list, keyed by
+// pipeline, material and view depth. With meshlets on, the draw is dropped
+// if no meshlet passes culling, and if enough are culled it covers only the
+// survivors, copied to the range's block of the meshlet stream. [begin, end)
+// lies within one RECORD_GRAIN block.
+static void record_draws(const RecordParams *params, uint32_t begin, uint32_t end) {
+    const Scene        *scene    = &state.scene;
+    DrawList           *list     = draw_lists_local(&state.draw_lists);
+    MeshletBlock       *block    = state.meshlets ? &state.meshlet_blocks[begin / RECORD_GRAIN] : NULL;
+    uint32_t            streamed = 0;
+    HMM_Mat4            world[RECORD_BATCH];
+    HMM_Mat4            batch[RECORD_BATCH];
+
+    if (block) {
+        block->list      = list;
+        block->cmd_first = list->count;
+    }
+    for (uint32_t i = begin; i < end; i += RECORD_BATCH) {
+        uint32_t  n   = end - i < RECORD_BATCH ? end - i : RECORD_BATCH;
+        HMM_Mat4 *mvp = state.pulled ? state.objects + i : batch;
+        for (uint32_t k = 0; k < n; k++) world[k] = scene->world[state.visible[i + k]];
+        transform_mul(params->view_proj, world, mvp, n);
+
+        for (uint32_t k = 0; k < n; k++) {
+            uint32_t           e        = state.visible[i + k];
+            uint32_t           material = scene->material[e];
+            const sg_bindings *bindings = pool_get(&state.materials, material);
+            const Mesh        *mesh     = pool_get(&state.meshes, scene->mesh[e]);
+            if (!bindings || !mesh) continue;
+            const MeshLod     *lod      = &mesh->lods[scene->lod[e]];
+
+            HMM_Vec3 center = HMM_V3(scene->sphere_x[e], scene->sphere_y[e], scene->sphere_z[e]);
+            float    depth  = HMM_DotV3(HMM_SubV3(center, params->eye), params->forward);
+
+            DrawCmd cmd = {
+                .sort_key      = draw_key(0, state.pip, material & POOL_INDEX_MASK, depth),
+                .pipeline      = state.pip,
+                .bindings      = bindings,
+                .base_element  = (int)lod->first_index,
+                .num_elements  = (int)lod->index_count,
+                .num_instances = 1,
+            };
+            if (block && block->indices) {
+                MeshletView view  = meshlet_view(&params->frustum, params->eye, world[k]);
+                view.inside       = frustum_contains_sphere(&params->frustum, center, scene->sphere_radius[e]);
+                uint8_t    *dst   = block->indices + (size_t)streamed * state.meshlet_index_size;
+                uint32_t    count = meshlet_cull(&mesh->data, scene->lod[e], &view, dst, &block->culled);
+                if (count == 0) continue;
+                if (count != MESHLET_CULL_NONE) {
+                    cmd.bindings     = &state.meshlet_bindings[pool_index(&state.materials, material)];
+                    cmd.base_element = (int)(block->first + streamed);
+                    cmd.num_elements = (int)count;
+                    streamed        += count;
+                }
+            }
+            if (state.pulled) {
+                // The MVP is already in place; the draw only carries its index
+                cmd.base_instance = (int)(i + k);
+                draw_list_add(list, &cmd, NULL, 0);
+            } else {
+                vs_params_t vs_params;
+                memcpy(vs_params.mvp, mvp[k].Elements, sizeof(vs_params.mvp));
+                cmd.uniform_slot = UB_vs_params;
+                draw_list_add(list, &cmd, &vs_params, sizeof(vs_params));
+            }
+        }
+    }
+    if (block) {
+        block->written = streamed;
+        block->cmd_end = list->count;
+    }
+}
+
+// job_parallel_for() hands out RECORD_GRAIN ranges, or everything at once
+// on a single thread, so split at block boundaries
+static void record_draws_job(void *data, uint32_t begin, uint32_t end) {
+    profile_begin("record job");
+    while (begin < end) {
+        uint32_t next = (begin / RECORD_GRAIN + 1) * RECORD_GRAIN;
+        if (next > end) next = end;
+        record_draws(data, begin, next);
+        begin = next;
+    }
+    profile_end();
+}
+
+// Append a job's output run, written at offset, to the first n items.
+// Runs are visited in offset order, so a run never moves forward.
+static uint32_t compact_run(uint32_t *items, uint32_t n, uint32_t offset, uint32_t count) {
+    memmove(items + n, items + offset, count * sizeof(uint32_t));
+    return n + count;
+}
+
+// Give each record job a block of meshlet_stream with room for its
+// entities at their selected LODs, growing the stream first if this frame
+// needs more. If it can't grow, blocks that don't fit draw unculled.
+static void reserve_meshlet_blocks(Arena *arena) {
+    uint32_t jobs  = (state.visible_count + RECORD_GRAIN - 1) / RECORD_GRAIN;
+    size_t   total = 0;
+    state.meshlet_blocks = arena_push(arena, MeshletBlock, jobs);
+    for (uint32_t c = 0; c < jobs; c++) {
+        uint32_t end   = state.visible_count - c * RECORD_GRAIN > RECORD_GRAIN ? (c + 1) * RECORD_GRAIN
+                                                                              : state.visible_count;
+        size_t   count = 0;
+        for (uint32_t i = c * RECORD_GRAIN; i < end; i++) {
+            uint32_t    e    = state.visible[i];
+            const Mesh *mesh = pool_get(&state.meshes, state.scene.mesh[e]);
+            if (mesh) count += mesh->lods[state.scene.lod[e]].index_count;
+        }
+        state.meshlet_blocks[c] = (MeshletBlock){ .size = count * state.meshlet_index_size };
+        total += (state.meshlet_blocks[c].size + 3) & ~(size_t)3;
+    }
+    if (total > state.meshlet_stream.capacity) stream_reserve(&state.meshlet_stream, total + total / 2);
+    for (uint32_t c = 0; c < jobs; c++) {
+        MeshletBlock *block  = &state.meshlet_blocks[c];
+        uint32_t      offset = 0;
+        block->indices = stream_alloc(&state.meshlet_stream, block->size, &offset);
+        block->first   = offset / state.meshlet_index_size;
+    }
+}
+
+// Move each block's written indices down to just after the previous
+// block's and shift its draws to match, so the upload holds only what
+// survived culling. Blocks are in stream order, so data never moves forward.
+static void pack_meshlet_blocks(void) {
+    uint32_t jobs = (state.visible_count + RECORD_GRAIN - 1) / RECORD_GRAIN;
+    uint32_t next = 0;
+    for (uint32_t c = 0; c < jobs; c++) {
+        MeshletBlock *block = &state.meshlet_blocks[c];
+        if (!block->indices) continue;
+        if (block->first != next) {
+            memmove(state.meshlet_stream.staging + (size_t)next * state.meshlet_index_size, block->indices,
+                    (size_t)block->written * state.meshlet_index_size);
+            int       shift  = (int)(block->first - next);
+            sg_buffer stream = stream_buffer(&state.meshlet_stream);
+            for (uint32_t i = block->cmd_first; i < block->cmd_end; i++) {
+                DrawCmd *cmd = &block->list->cmds[i];
+                if (cmd->bindings->index_buffer.id == stream.id) cmd->base_element -= shift;
+            }
+        }
+        next += block->written;
+    }
+    stream_rewind(&state.meshlet_stream, (size_t)next * state.meshlet_index_size);
+}
+
 static void init(void) {
+    stm_setup();
+    frame_timing_startup();
+    profile_thread_name("main");
+    profile_begin("init");
+
+    // threads=N on the command line, 0 (default) for one per core
+    job_system_init((uint32_t)atoi(sargs_value_def("threads", "0")));
+
     sg_setup(&(sg_desc){
         .environment = sglue_environment(),
         .logger.func = slog_func,
     });
+    gpu_timer_setup();
+    stats_setup(0);
+    texture_setup();
 
-    float vertices[] = {
-        // position            // uv
-        // Front face
-         0.0f,  0.5f,  0.0f,  0.5f, 0.5f,
-        -0.5f, -0.5f,  0.5f,  0.0f, 1.0f,
-         0.5f, -0.5f,  0.5f,  1.0f, 1.0f,
-        // Right face
-         0.0f,  0.5f,  0.0f,  0.5f, 0.5f,
-         0.5f, -0.5f,  0.5f,  1.0f, 1.0f,
-         0.5f, -0.5f, -0.5f,  1.0f, 0.0f,
-        // Back face
-         0.0f,  0.5f,  0.0f,  0.5f, 0.5f,
-         0.5f, -0.5f, -0.5f,  1.0f, 0.0f,
-        -0.5f, -0.5f, -0.5f,  0.0f, 0.0f,
-        // Left face
-         0.0f,  0.5f,  0.0f,  0.5f, 0.5f,
-        -0.5f, -0.5f, -0.5f,  0.0f, 0.0f,
-        -0.5f, -0.5f,  0.5f,  0.0f, 1.0f,
-    };
-    state.bind.vertex_buffers[0] = sg_make_buffer(&(sg_buffer_desc){
-        .data  = SG_RANGE(vertices),
-        .label = "pyramid-vertices"
-    });
+    pool_init(&state.meshes, MAX_MESHES, sizeof(Mesh));
+    pool_init(&state.materials, MAX_MATERIALS, sizeof(sg_bindings));
 
-    int width, height, channels;
-    stbi_set_flip_vertically_on_load(true);
-    unsigned char *pixels = stbi_load("data/textures/obamna.png", &width, &height, &channels, 4);
-    state.img = sg_make_image(&(sg_image_desc){
-        .width  = width,
-        .height = height,
-        .data.mip_levels[0] = { .ptr = pixels, .size = (size_t)(width * height * 4) },
-        .label  = "pyramid texture"
-    });
-    stbi_image_free(pixels);
+    state.pyramid = pool_alloc(&state.meshes);
+    Mesh *mesh    = pool_get(&state.meshes, state.pyramid);
+    profile_begin("load mesh");
+    state.mesh_path = sargs_value_def("mesh", DEFAULT_MESH_PATH);
+    bool loaded     = mesh_load(mesh, state.mesh_path);
+    profile_end();
+    if (!loaded) {
+        fprintf(stderr, "failed to load %s\n", state.mesh_path);
+        profile_end();
+        sapp_quit();
+        return;
+    }
+    for (int m = 0; m < MATERIAL_COUNT; m++) {
+        state.material_handles[m] = pool_alloc(&state.materials);
+        sg_bindings *bindings     = pool_get(&state.materials, state.material_handles[m]);
+        bindings->vertex_buffers[0] = mesh->vertex_buffer;
+        bindings->index_buffer      = mesh->index_buffer;
+    }
+
+    // Uses the cooked mip chain if present, else streams in on sokol_fetch's
+    // IO threads with a placeholder bound until then
+    profile_begin("load texture");
+    texture_load(&state.texture, "data/textures/obamna.png");
+    profile_end();
 
-    state.img_view = sg_make_view(&(sg_view_desc){
-        .texture.image = state.img,
-        .label         = "pyramid-texture-view",
+    state.samplers[MATERIAL_SMOOTH] = sg_make_sampler(&(sg_sampler_desc){
+        .min_filter    = SG_FILTER_LINEAR,
+        .mag_filter    = SG_FILTER_LINEAR,
+        .mipmap_filter = SG_FILTER_LINEAR,
+        .wrap_u        = SG_WRAP_REPEAT,
+        .wrap_v        = SG_WRAP_REPEAT,
+        .label         = "pyramid-sampler",
     });
-    state.smp = sg_make_sampler(&(sg_sampler_desc){
-        .min_filter = SG_FILTER_LINEAR,
-        .mag_filter = SG_FILTER_LINEAR,
-        .wrap_u     = SG_WRAP_REPEAT,
-        .wrap_v     = SG_WRAP_REPEAT,
-        .label      = "pyramid-sampler",
+    state.samplers[MATERIAL_PIXELATED] = sg_make_sampler(&(sg_sampler_desc){
+        .min_filter    = SG_FILTER_NEAREST,
+        .mag_filter    = SG_FILTER_NEAREST,
+        .mipmap_filter = SG_FILTER_NEAREST,
+        .wrap_u        = SG_WRAP_REPEAT,
+        .wrap_v        = SG_WRAP_REPEAT,
+        .label         = "pyramid-pixelated-sampler",
     });
+    for (int m = 0; m < MATERIAL_COUNT; m++) {
+        sg_bindings *bindings = pool_get(&state.materials, state.material_handles[m]);
+        bindings->samplers[SMP_smp] = state.samplers[m];
+    }
 
-    state.bind.views[VIEW_tex]   = state.img_view;
-    state.bind.samplers[SMP_smp] = state.smp;
-
-    state.pip = sg_make_pipeline(&(sg_pipeline_desc){
-        .shader = sg_make_shader(pyramid_shader_desc(sg_query_backend())),
-        .layout = {
-            .attrs = {
-                [ATTR_pyramid_position].format = SG_VERTEXFORMAT_FLOAT3,
-                [ATTR_pyramid_texcoord].format = SG_VERTEXFORMAT_FLOAT2,
-            }
-        },
+    sg_pipeline_desc pip_desc = {
+        .layout.buffers[0].stride = sizeof(MeshVertex),
         .depth = {
             .compare       = SG_COMPAREFUNC_LESS_EQUAL,
             .write_enabled = true,
         },
+        .index_type   = mesh->index_type,
         .cull_mode    = SG_CULLMODE_BACK,
         .face_winding = SG_FACEWINDING_CCW,
         .label        = "pyramid-pipeline"
-    });
+    };
+    int instances   = atoi(sargs_value_def("instances", "0"));
+    state.grid      = instances > 0;
+    state.instanced = state.grid && !sargs_equals("instancing", "off");
+    sg_features features = sg_query_features();
+    state.pulled    = !state.instanced && features.compute && features.draw_base_instance;
+#if defined(SOKOL_DUMMY_BACKEND)
+    state.pulled_force = !state.instanced && !state.pulled && sargs_equals("pulled", "on");
+    state.pulled       = state.pulled || state.pulled_force;
+#endif
+    int occluders   = atoi(sargs_value_def("occluders", "0"));
+    if (occluders < 0) occluders = 0;
+    uint32_t capacity = (state.grid ? (uint32_t)instances : 1) + (uint32_t)occluders;
+    if (!scene_init(&state.scene, capacity)) {
+        fprintf(stderr, "failed to allocate a scene of %u entities (at most %u)\n", capacity, POOL_MAX_CAPACITY);
+        profile_end();
+        sapp_quit();
+        return;
+    }
+    if (state.grid) {
+        add_pyramid_grid(&state.scene, (uint32_t)instances);
+    } else {
+        // A single pyramid at the origin
+        scene_add(&state.scene, HMM_V3(0.0f, 0.0f, 0.0f), HMM_Q(0.0f, 0.0f, 0.0f, 1.0f), HMM_V3(1.0f, 1.0f, 1.0f),
+                  state.pyramid, state.material_handles[MATERIAL_SMOOTH]);
+    }
+    add_occluders(&state.scene, (uint32_t)occluders);
+
+    // The occluders' triangles are read on the CPU from their own mapping
+    state.occlusion_enabled = occluders > 0 && !sargs_equals("occlusion", "off") &&
+                              mesh_data_map(&state.occluder_mesh, state.mesh_path) &&
+                              occlusion_init(&state.occlusion, OCCLUSION_WIDTH, OCCLUSION_HEIGHT);
+
+    if (state.instanced) {
+        state.instance_buffer = sg_make_buffer(&(sg_buffer_desc){
+            .size  = state.scene.count * sizeof(HMM_Mat4),
+            .usage.stream_update = true,
+            .label = "pyramid-instances",
+        });
+        for (uint32_t m = 0; m < state.materials.count; m++) {
+            ((sg_bindings *)pool_at(&state.materials, m))->vertex_buffers[1] = state.instance_buffer;
+        }
+
+        pip_desc.shader = sg_make_shader(shader_desc(pyramid_instanced_shader_desc));
+        pip_desc.layout.buffers[1] = (sg_vertex_buffer_layout_state){
+            .stride    = sizeof(HMM_Mat4),
+            .step_func = SG_VERTEXSTEP_PER_INSTANCE,
+        };
+        pip_desc.layout.attrs[ATTR_pyramid_instanced_position].format = SG_VERTEXFORMAT_FLOAT3;
+        pip_desc.layout.attrs[ATTR_pyramid_instanced_texcoord].format = SG_VERTEXFORMAT_FLOAT2;
+        for (int col = 0; col < 4; col++) {
+            pip_desc.layout.attrs[ATTR_pyramid_instanced_model0 + col] = (sg_vertex_attr_state){
+                .buffer_index = 1,
+                .offset       = col * (int)sizeof(HMM_Vec4),
+                .format       = SG_VERTEXFORMAT_FLOAT4,
+            };
+        }
+        pip_desc.label = "pyramid-instanced-pipeline";
+    } else if (state.pulled && !state.pulled_force) {
+        state.object_buffer = sg_make_buffer(&(sg_buffer_desc){
+            .size  = state.scene.capacity * sizeof(HMM_Mat4),
+            .usage = { .storage_buffer = true, .stream_update = true },
+            .label = "pyramid-objects",
+        });
+        state.object_view = sg_make_view(&(sg_view_desc){
+            .storage_buffer.buffer = state.object_buffer,
+            .label                 = "pyramid-objects-view",
+        });
+
+        // Instance i reads object_index i, so a draw's base instance picks
+        // its object
+        uint32_t *indices = malloc(state.scene.capacity * sizeof(uint32_t));
+        for (uint32_t i = 0; i < state.scene.capacity; i++) indices[i] = i;
+        state.object_index_buffer = sg_make_buffer(&(sg_buffer_desc){
+            .data  = { indices, state.scene.capacity * sizeof(uint32_t) },
+            .label = "pyramid-object-indices",
+        });
+        free(indices);
+        for (uint32_t m = 0; m < state.materials.count; m++) {
+            sg_bindings *bindings = pool_at(&state.materials, m);
+            bindings->vertex_buffers[1]   = state.object_index_buffer;
+            bindings->views[VIEW_objects] = state.object_view;
+        }
+
+        pip_desc.shader = sg_make_shader(shader_desc(pyramid_pulled_shader_desc));
+        pip_desc.layout.buffers[1] = (sg_vertex_buffer_layout_state){
+            .stride    = sizeof(uint32_t),
+            .step_func = SG_VERTEXSTEP_PER_INSTANCE,
+        };
+        pip_desc.layout.attrs[ATTR_pyramid_pulled_position].format = SG_VERTEXFORMAT_FLOAT3;
+        pip_desc.layout.attrs[ATTR_pyramid_pulled_texcoord].format = SG_VERTEXFORMAT_FLOAT2;
+        pip_desc.layout.attrs[ATTR_pyramid_pulled_object_index] = (sg_vertex_attr_state){
+            .buffer_index = 1,
+            .format       = SG_VERTEXFORMAT_UINT,
+        };
+        pip_desc.label = "pyramid-pulled-pipeline";
+    } else {
+        pip_desc.shader = sg_make_shader(shader_desc(pyramid_shader_desc));
+        pip_desc.layout.attrs[ATTR_pyramid_position].format = SG_VERTEXFORMAT_FLOAT3;
+        pip_desc.layout.attrs[ATTR_pyramid_texcoord].format = SG_VERTEXFORMAT_FLOAT2;
+    }
+    state.pip = sg_make_pipeline(&pip_desc);
+
+    set_mesh_bounds(&state.scene);
+    scene_update_transforms(&state.scene, NULL);
+    bvh_init(&state.bvh, state.scene.capacity);
+    bvh_build(&state.bvh, &state.scene);
+
+    // Entities only move in place, so the tree shape and its split are fixed
+    uint32_t max_splits    = job_thread_count() * CULL_SPLITS_PER_THREAD;
+    state.cull_splits      = malloc(max_splits * sizeof(BvhSubtree));
+    state.cull_split_count = bvh_split(&state.bvh, state.cull_splits, max_splits);
+    frame_arena_init(&state.frame_arena, FRAME_ARENA_SIZE);
+
+    // Room for an even share of the scene's draws per thread up front
+    uint32_t threads = job_thread_count();
+    uint32_t share   = state.instanced ? 1 : state.scene.capacity / threads + 1;
+    draw_lists_init(&state.draw_lists, threads, share, share * (uint32_t)sizeof(vs_params_t));
+
+    // Every entity draws the one mesh. A mesh with a LOD lacking meshlets
+    // would draw nothing, so it keeps plain draws.
+    state.meshlets = !state.instanced && sargs_equals("meshlets", "on") && meshlet_covers(&mesh->data);
+    if (state.meshlets) {
+        state.meshlet_index_size = mesh->index_type == SG_INDEXTYPE_UINT32 ? 4 : 2;
+        state.meshlets = stream_init(&state.meshlet_stream, MESHLET_STREAM_SIZE, true, "meshlet-indices");
+    }
 
     state.pass_action = (sg_pass_action){
         .colors[0] = { .load_action = SG_LOADACTION_CLEAR, .clear_value = {0.1f, 0.1f, 0.1f, 1.0f} },
@@ -106,33 +740,268 @@ static void init(void) {
     };
 
     camera_init(&state.camera, HMM_V3(0.0f, 1.0f, 3.0f), HMM_PI);
+    state.capture_frame = (uint32_t)atoi(sargs_value_def("capture_frame", "0"));
+    state.lod_threshold = sargs_exists("lod_error") ? (float)atof(sargs_value("lod_error")) : LOD_DEFAULT_ERROR_PIXELS;
+    state.ready         = true;
+    profile_end();
+}
+
+static uint32_t unorm8(float channel) {
+    return (uint32_t)(channel * 255.0f + 0.5f);
+}
+
+// Replay this frame's recorded draws on the CPU rasterizer and write the
+// picture to path. It uses the same MVPs, instance data and materials the
+// GPU gets, so a change to culling, batching or recording that alters the
+// image shows up in it. Every entity draws the mesh from mesh_path.
+static bool capture(const char *path) {
+    MeshData mesh;
+    if (!mesh_data_map(&mesh, state.mesh_path)) return false;
+    int      tex_w, tex_h, channels;
+    stbi_uc *pixels = stbi_load("data/textures/obamna.png", &tex_w, &tex_h, &channels, 4);
+    Raster   raster;
+    if (!pixels || !raster_init(&raster, (uint32_t)sapp_width(), (uint32_t)sapp_height())) {
+        stbi_image_free(pixels);
+        mesh_data_unmap(&mesh);
+        return false;
+    }
+    RasterTexture textures[MATERIAL_COUNT];
+    for (int m = 0; m < MATERIAL_COUNT; m++) {
+        textures[m] = (RasterTexture){
+            .texels  = (const uint32_t *)pixels,
+            .width   = (uint32_t)tex_w,
+            .height  = (uint32_t)tex_h,
+            .nearest = m == MATERIAL_PIXELATED,
+        };
+    }
+
+    sg_color          clear = state.pass_action.colors[0].clear_value;
+    const MeshHeader *h     = mesh.header;
+    raster_begin(&raster, unorm8(clear.r) | unorm8(clear.g) << 8 | unorm8(clear.b) << 16 | unorm8(clear.a) << 24,
+                 state.pass_action.depth.clear_value);
+    for (uint32_t l = 0; l < state.draw_lists.list_count; l++) {
+        const DrawList *list = &state.draw_lists.lists[l];
+        for (uint32_t i = 0; i < list->count; i++) {
+            const DrawCmd       *cmd = &list->cmds[i];
+            const RasterTexture *tex = &textures[MATERIAL_SMOOTH];
+            if (cmd->bindings->samplers[SMP_smp].id == state.samplers[MATERIAL_PIXELATED].id) {
+                tex = &textures[MATERIAL_PIXELATED];
+            }
+
+            // Meshlet draws index this frame's stream, still in its staging area
+            bool           streamed = state.meshlets &&
+                                      cmd->bindings->index_buffer.id == stream_buffer(&state.meshlet_stream).id;
+            const uint8_t *indices  = streamed ? state.meshlet_stream.staging : mesh.indices;
+            const void    *uniforms = list->uniforms + cmd->uniform_offset;
+            HMM_Mat4       mvp;
+            for (int k = 0; k < cmd->num_instances; k++) {
+                if (state.instanced) {
+                    const HMM_Mat4 *world = state.visible_world +
+                                            cmd->bindings->vertex_buffer_offsets[1] / (int)sizeof(HMM_Mat4);
+                    memcpy(&mvp, ((const vs_instanced_params_t *)uniforms)->view_proj, sizeof(mvp));
+                    mvp = HMM_MulM4(mvp, world[k]);
+                } else if (state.pulled) {
+                    mvp = state.objects[cmd->base_instance + k];
+                } else {
+                    memcpy(&mvp, ((const vs_params_t *)uniforms)->mvp, sizeof(mvp));
+                }
+                raster_draw(&raster, mesh.vertices, h->vertex_count,
+                            indices + (size_t)cmd->base_element * h->index_size, h->index_size,
+                            (uint32_t)cmd->num_elements, mvp, tex);
+            }
+        }
+    }
+    raster_end(&raster);
+
+    bool ok = image_write_png(path, raster.color, raster.width, raster.height, raster.stride);
+    raster_free(&raster);
+    stbi_image_free(pixels);
+    mesh_data_unmap(&mesh);
+    return ok;
+}
+
+// Stats overlay: there is no text rendering yet, so the last window's
+// summary goes in the title bar
+static void show_stats(void) {
+    StatSummary cpu     = stats_summary(STAT_CPU_MS);
+    StatSummary gpu     = stats_summary(STAT_GPU_MS);
+    StatSummary draws   = stats_summary(STAT_DRAWS);
+    StatSummary uploads = stats_summary(STAT_UPLOAD_BYTES);
+    char title[160];
+    snprintf(title, sizeof(title), "%s | cpu %.2f ms (p99 %.2f) | gpu %.2f ms | %.0f draws | %.1f KB up",
+             WINDOW_TITLE, cpu.avg, cpu.p99, gpu.avg, draws.avg, uploads.avg / 1024.0);
+    sapp_set_window_title(title);
 }
 
 static void frame(void) {
+    if (!state.ready) return;
     float dt     = (float)sapp_frame_duration();
     float aspect = (float)sapp_width() / (float)sapp_height();
 
+    frame_timing_begin();
+
     // Update
+    texture_update();
     camera_move(&state.camera, state.input.move, dt);
     camera_look(&state.camera, state.input.mouse_dx, state.input.mouse_dy);
+    state.time += dt;
+    if (state.grid) spin_entities(&state.scene, state.time * INSTANCE_SPIN_SPEED);
+    frame_timing_end_phase(FRAME_PHASE_UPDATE);
+
+    // Build matrices, fanned out over the job system. Instanced mode only
+    // needs view-projection, the world matrices go to the GPU in the
+    // instance buffer.
+    Arena *arena       = frame_arena_current(&state.frame_arena);
+    state.moved        = arena_push(arena, uint32_t, state.scene.count);
+    state.moved_counts = arena_push(arena, uint32_t, state.scene.count / JOB_GRAIN + 1);
+    job_parallel_for(state.scene.count, JOB_GRAIN, update_transforms_job, NULL);
+    state.moved_count = 0;
+    for (uint32_t c = 0; c * JOB_GRAIN < state.scene.count; c++) {
+        state.moved_count = compact_run(state.moved, state.moved_count, c * JOB_GRAIN, state.moved_counts[c]);
+    }
+    HMM_Mat4 proj      = camera_projection(&state.camera, aspect);
+    HMM_Mat4 view      = camera_view(&state.camera);
+    HMM_Mat4 view_proj = HMM_MulM4(proj, view);
+    frame_timing_end_phase(FRAME_PHASE_BUILD);
 
-    // Build MVP — model is identity for now
-    HMM_Mat4 proj  = camera_projection(&state.camera, aspect);
-    HMM_Mat4 view  = camera_view(&state.camera);
-    HMM_Mat4 model = HMM_M4D(1.0f);
-    HMM_Mat4 mvp   = HMM_MulM4(HMM_MulM4(proj, view), model);
+    // Cull. Entities outside the frustum get no upload and no draw.
+    CullParams cull = {
+        .frustum         = frustum_from_matrix(view_proj),
+        .eye             = state.camera.position,
+        .pixels_per_unit = (float)sapp_height() / (2.0f * tanf(state.camera.fov * 0.5f)),
+    };
+    Scene  *scene   = &state.scene;
+    bvh_refit_moved(&state.bvh, scene, state.moved, state.moved_count);
+    state.visible     = arena_push(arena, uint32_t, scene->count);
+    state.cull_counts = arena_push(arena, uint32_t, state.cull_split_count);
+    if (state.occlusion_enabled) {
+        const MeshHeader *h = state.occluder_mesh.header;
+        profile_begin("occluders");
+        occlusion_begin(&state.occlusion, view_proj);
+        for (uint32_t e = state.occluder_first; e < state.occluder_first + state.occluder_count; e++) {
+            occlusion_add_occluder(&state.occlusion, state.occluder_mesh.vertices, h->vertex_count,
+                                   state.occluder_mesh.indices, h->index_size, h->lods[0].index_count,
+                                   scene->world[e]);
+        }
+        occlusion_end(&state.occlusion);
+        profile_end();
+        state.occluded_counts = arena_push(arena, uint32_t, state.cull_split_count);
+    }
+    job_parallel_for(state.cull_split_count, 1, cull_job, &cull);
+    state.visible_count = 0;
+    uint32_t occluded   = 0;
+    for (uint32_t i = 0; i < state.cull_split_count; i++) {
+        state.visible_count = compact_run(state.visible, state.visible_count, state.cull_splits[i].first,
+                                          state.cull_counts[i]);
+        if (state.occlusion_enabled) occluded += state.occluded_counts[i];
+    }
+    frame_timing_count(FRAME_COUNTER_OCCLUDED, occluded);
+    if (state.instanced) {
+        state.visible_tmp   = arena_push(arena, uint32_t, state.visible_count);
+        state.visible_world = arena_push(arena, HMM_Mat4, state.visible_count);
+        sort_visible_by_run();
+        job_parallel_for(state.visible_count, JOB_GRAIN, gather_visible_job, NULL);
+    }
+    frame_timing_end_phase(FRAME_PHASE_CULL);
 
-    vs_params_t vs_params;
-    memcpy(vs_params.mvp, mvp.Elements, sizeof(vs_params.mvp));
+    // Record draw commands. sokol_gfx is single-threaded, so jobs only fill
+    // their thread's draw list and the sg_* calls happen in SUBMIT.
+    if (state.meshlets) reserve_meshlet_blocks(arena);
+    for (uint32_t m = 0; m < state.materials.count; m++) {
+        sg_bindings *bindings = pool_at(&state.materials, m);
+        bindings->views[VIEW_tex] = texture_view(&state.texture);
+        if (state.meshlets) {
+            state.meshlet_bindings[m] = *bindings;
+            state.meshlet_bindings[m].index_buffer = stream_buffer(&state.meshlet_stream);
+        }
+    }
+    draw_lists_reset(&state.draw_lists, arena);
+    if (state.instanced) {
+        // Every instanced entity draws the one mesh
+        const Mesh *mesh = pool_get(&state.meshes, state.pyramid);
+        vs_instanced_params_t vs_instanced_params;
+        memcpy(vs_instanced_params.view_proj, view_proj.Elements, sizeof(vs_instanced_params.view_proj));
+        for (uint32_t r = 0; r < state.materials.count * MESH_MAX_LODS; r++) {
+            if (state.run_count[r] == 0) continue;
+            // Runs of one material differ only in their instance buffer
+            // offset, so each gets its own copy of the bindings
+            uint32_t     m        = r / MESH_MAX_LODS;
+            sg_bindings *bindings = arena_push(arena, sg_bindings, 1);
+            *bindings = *(const sg_bindings *)pool_at(&state.materials, m);
+            bindings->vertex_buffer_offsets[1] = (int)(state.run_first[r] * sizeof(HMM_Mat4));
+            const MeshLod *lod = &mesh->lods[r % MESH_MAX_LODS];
+            draw_list_add(draw_lists_local(&state.draw_lists), &(DrawCmd){
+                .sort_key      = draw_key(0, state.pip, state.materials.handles[m] & POOL_INDEX_MASK, 0.0f),
+                .pipeline      = state.pip,
+                .bindings      = bindings,
+                .uniform_slot  = UB_vs_instanced_params,
+                .base_element  = (int)lod->first_index,
+                .num_elements  = (int)lod->index_count,
+                .num_instances = (int)state.run_count[r],
+            }, &vs_instanced_params, sizeof(vs_instanced_params));
+        }
+    } else {
+        if (state.pulled) state.objects = arena_push(arena, HMM_Mat4, state.visible_count);
+        RecordParams params = {
+            .view_proj = view_proj,
+            .frustum   = cull.frustum,
+            .eye       = state.camera.position,
+            .forward   = camera_forward(&state.camera),
+        };
+        job_parallel_for(state.visible_count, RECORD_GRAIN, record_draws_job, &params);
+    }
+    if (state.meshlets) {
+        pack_meshlet_blocks();
+        uint32_t culled = 0;
+        for (uint32_t c = 0; c * RECORD_GRAIN < state.visible_count; c++) culled += state.meshlet_blocks[c].culled;
+        frame_timing_count(FRAME_COUNTER_MESHLETS_CULLED, culled);
+    }
+    frame_timing_end_phase(FRAME_PHASE_RECORD);
 
     // Draw
+    if (state.instanced && state.visible_count > 0) {
+        sg_update_buffer(state.instance_buffer, &(sg_range){
+            state.visible_world, state.visible_count * sizeof(HMM_Mat4)
+        });
+    }
+    if (state.pulled && !state.pulled_force && state.visible_count > 0) {
+        sg_update_buffer(state.object_buffer, &(sg_range){
+            state.objects, state.visible_count * sizeof(HMM_Mat4)
+        });
+    }
+    if (state.meshlets) stream_flush(&state.meshlet_stream);
+    gpu_timer_begin(FRAME_GPU_MAIN);
     sg_begin_pass(&(sg_pass){ .action = state.pass_action, .swapchain = sglue_swapchain() });
-    sg_apply_pipeline(state.pip);
-    sg_apply_bindings(&state.bind);
-    sg_apply_uniforms(UB_vs_params, &SG_RANGE(vs_params));
-    sg_draw(0, 12, 1);
+    profile_begin("draw submit");
+    if (!state.pulled_force) draw_lists_submit(&state.draw_lists);
     sg_end_pass();
+    gpu_timer_end(FRAME_GPU_MAIN);
+    profile_end();
+
+    const DrawStats *stats = &state.draw_lists.stats;
+    frame_timing_count(FRAME_COUNTER_DRAWS,            stats->draws);
+    frame_timing_count(FRAME_COUNTER_PIPELINES,        stats->pipelines);
+    frame_timing_count(FRAME_COUNTER_PIPELINES_ELIDED, stats->pipelines_elided);
+    frame_timing_count(FRAME_COUNTER_BINDINGS,         stats->bindings);
+    frame_timing_count(FRAME_COUNTER_BINDINGS_ELIDED,  stats->bindings_elided);
+    frame_timing_count(FRAME_COUNTER_TRIANGLES,        stats->triangles);
+    profile_begin("sg_commit");
     sg_commit();
+    profile_end();
+    gpu_timer_end_frame();
+    for (int p = 0; p < FRAME_GPU_COUNT; p++) frame_timing_gpu((FrameGpuPass)p, gpu_timer_result((uint32_t)p));
+    frame_timing_end_phase(FRAME_PHASE_SUBMIT);
+    frame_timing_end();
+    stats_frame(frame_timing_last());
+    if (stats_window_done()) show_stats();
+
+    if (state.frame_index++ == state.capture_frame && sargs_exists("capture") && !capture(sargs_value("capture"))) {
+        fprintf(stderr, "failed to capture %s\n", sargs_value("capture"));
+    }
+
+    // Last frame's arena is reset for reuse; this one stays intact for a frame
+    frame_arena_swap(&state.frame_arena);
+    if (state.meshlets) stream_next_frame(&state.meshlet_stream);
 
     // Must be last — clears per-frame mouse delta
     input_end_frame(&state.input);
@@ -164,11 +1033,41 @@ static void event(const sapp_event *e) {
 }
 
 static void cleanup(void) {
+    // trace=file.json writes the profiler's buffered events on exit
+    if (sargs_exists("trace") && !profile_export_chrome(sargs_value("trace"))) {
+        fprintf(stderr, "failed to write %s\n", sargs_value("trace"));
+    }
+
+    // stats=file.csv writes the rolling gfx stats summary on exit
+    if (sargs_exists("stats") && !stats_write_csv(sargs_value("stats"))) {
+        fprintf(stderr, "failed to write %s\n", sargs_value("stats"));
+    }
+
+    draw_lists_free(&state.draw_lists);
+    if (state.meshlets) stream_destroy(&state.meshlet_stream);
+    frame_arena_free(&state.frame_arena);
+    free(state.cull_splits);
+    occlusion_free(&state.occlusion);
+    mesh_data_unmap(&state.occluder_mesh);
+    bvh_free(&state.bvh);
+    scene_free(&state.scene);
+    for (uint32_t m = 0; m < state.meshes.count; m++) mesh_destroy(pool_at(&state.meshes, m));
+    pool_free(&state.meshes);
+    pool_free(&state.materials);
+    texture_shutdown();
+    stats_shutdown();
+    gpu_timer_shutdown();
     sg_shutdown();
+    job_system_shutdown();
+    sargs_shutdown();
+
+    // Leave nothing behind, so init() can run again (bench golden does)
+    memset(&state, 0, sizeof(state));
 }
 
 sapp_desc sokol_main(int argc, char *argv[]) {
-    (void)argc; (void)argv;
+    // key=value options, e.g. instances=10000 instancing=off threads=4
+    sargs_setup(&(sargs_desc){ .argc = argc, .argv = argv });
     return (sapp_desc){
         .init_cb      = init,
         .frame_cb     = frame,
@@ -176,7 +1075,7 @@ sapp_desc sokol_main(int argc, char *argv[]) {
         .event_cb     = event,
         .width        = 640,
         .height       = 480,
-        .window_title = "3d engine",
+        .window_title = WINDOW_TITLE,
         .icon.sokol_default = true,
         .logger.func  = slog_func,
     };
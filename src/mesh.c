@@ -0,0 +1,159 @@
+#include "mesh.h"
+#include "mesh_format.h"
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Sections are read in place, so they must also be aligned for their type
+static bool section_fits(size_t file_size, uint32_t offset, uint64_t size) {
+    return offset % MESH_ALIGN == 0 && (uint64_t)offset + size <= file_size;
+}
+
+static bool lods_fit(const MeshHeader *h) {
+    if (h->lod_count == 0 || h->lod_count > MESH_MAX_LODS) return false;
+    for (uint32_t l = 0; l < h->lod_count; l++) {
+        const MeshLod *lod = &h->lods[l];
+        if (lod->index_count == 0 || lod->index_count % 3 != 0 ||
+            (uint64_t)lod->first_index + lod->index_count > h->index_count ||
+            (uint64_t)lod->first_meshlet + lod->meshlet_count > h->meshlet_count) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Every meshlet's index run must lie within its LOD's, and together they may
+// not cover more than it, since culling copies them into room for the LOD
+static bool meshlets_fit(const MeshHeader *h, const Meshlet *meshlets) {
+    for (uint32_t l = 0; l < h->lod_count; l++) {
+        const MeshLod *lod   = &h->lods[l];
+        uint64_t       total = 0;
+        for (uint32_t i = lod->first_meshlet; i < lod->first_meshlet + lod->meshlet_count; i++) {
+            const Meshlet *m = &meshlets[i];
+            if (m->index_count % 3 != 0 || m->first_index < lod->first_index ||
+                (uint64_t)m->first_index + m->index_count > (uint64_t)lod->first_index + lod->index_count) {
+                return false;
+            }
+            total += m->index_count;
+        }
+        if (total > lod->index_count) return false;
+    }
+    return true;
+}
+
+// Every index must name a vertex, or drawing it reads past the vertex buffer
+static bool indices_fit(const MeshHeader *h, const uint8_t *indices) {
+    uint32_t max = 0;
+    if (h->index_size == 2) {
+        const uint16_t *i16 = (const uint16_t *)indices;
+        for (uint32_t i = 0; i < h->index_count; i++) max = i16[i] > max ? i16[i] : max;
+    } else {
+        const uint32_t *i32 = (const uint32_t *)indices;
+        for (uint32_t i = 0; i < h->index_count; i++) max = i32[i] > max ? i32[i] : max;
+    }
+    return max < h->vertex_count;
+}
+
+static bool parse_header(const uint8_t *map, size_t size) {
+    const MeshHeader *h = (const MeshHeader *)map;
+    return size >= sizeof(*h)
+        && h->magic == MESH_MAGIC
+        && h->version == MESH_VERSION
+        && h->vertex_stride == sizeof(MeshVertex)
+        && h->vertex_count > 0
+        && h->index_count > 0 && h->index_count % 3 == 0
+        && (h->index_size == 2 || h->index_size == 4)
+        && lods_fit(h)
+        && section_fits(size, h->vertex_offset, (uint64_t)h->vertex_count * h->vertex_stride)
+        && section_fits(size, h->index_offset,  (uint64_t)h->index_count  * h->index_size)
+        && section_fits(size, h->meshlet_offset, (uint64_t)h->meshlet_count * sizeof(Meshlet))
+        && indices_fit(h, map + h->index_offset)
+        && meshlets_fit(h, (const Meshlet *)(map + h->meshlet_offset));
+}
+
+bool mesh_data_map(MeshData *data, const char *path) {
+    *data = (MeshData){0};
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        close(fd);
+        return false;
+    }
+    size_t size = (size_t)st.st_size;
+    void *map = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) return false;
+    if (!parse_header(map, size)) {
+        munmap(map, size);
+        return false;
+    }
+
+    const uint8_t    *base = map;
+    const MeshHeader *h    = map;
+    *data = (MeshData){
+        .map      = map,
+        .map_size = size,
+        .header   = h,
+        .vertices = (const MeshVertex *)(base + h->vertex_offset),
+        .indices  = base + h->index_offset,
+        .meshlets = (const Meshlet *)(base + h->meshlet_offset),
+    };
+    return true;
+}
+
+void mesh_data_unmap(MeshData *data) {
+    if (data->map) munmap(data->map, data->map_size);
+    *data = (MeshData){0};
+}
+
+bool mesh_load(Mesh *mesh, const char *path) {
+    *mesh = (Mesh){0};
+
+    MeshData data;
+    if (!mesh_data_map(&data, path)) return false;
+    const MeshHeader *h = data.header;
+
+    // Buffers are created straight from the mapping
+    mesh->vertex_buffer = sg_make_buffer(&(sg_buffer_desc){
+        .data  = { data.vertices, (size_t)h->vertex_count * h->vertex_stride },
+        .label = "mesh-vertices",
+    });
+    mesh->index_buffer = sg_make_buffer(&(sg_buffer_desc){
+        .usage.index_buffer = true,
+        .data  = { data.indices, (size_t)h->index_count * h->index_size },
+        .label = "mesh-indices",
+    });
+    mesh->index_type    = h->index_size == 2 ? SG_INDEXTYPE_UINT16 : SG_INDEXTYPE_UINT32;
+    mesh->vertex_count  = (int)h->vertex_count;
+    mesh->index_count   = (int)h->lods[0].index_count;
+    mesh->bounds_min    = HMM_V3(h->bounds_min[0], h->bounds_min[1], h->bounds_min[2]);
+    mesh->bounds_max    = HMM_V3(h->bounds_max[0], h->bounds_max[1], h->bounds_max[2]);
+    mesh->sphere_center = HMM_V3(h->sphere_center[0], h->sphere_center[1], h->sphere_center[2]);
+    mesh->sphere_radius = h->sphere_radius;
+    mesh->lod_count     = h->lod_count;
+    memcpy(mesh->lods, h->lods, sizeof(mesh->lods));
+    mesh->data          = data;
+    return true;
+}
+
+void mesh_destroy(Mesh *mesh) {
+    sg_destroy_buffer(mesh->vertex_buffer);
+    sg_destroy_buffer(mesh->index_buffer);
+    mesh_data_unmap(&mesh->data);
+    *mesh = (Mesh){0};
+}
+
+uint32_t mesh_select_lod(const Mesh *mesh, uint32_t current, float pixels_per_unit, float threshold) {
+    if (mesh->lod_count == 0) return 0;
+    uint32_t lod = current < mesh->lod_count ? current : mesh->lod_count - 1;
+    while (lod > 0 && mesh->lods[lod].error * pixels_per_unit > threshold) lod--;
+    while (lod + 1 < mesh->lod_count &&
+           mesh->lods[lod + 1].error * pixels_per_unit <= threshold * MESH_LOD_HYSTERESIS) {
+        lod++;
+    }
+    return lod;
+}
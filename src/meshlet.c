@@ -0,0 +1,131 @@
+#include "meshlet.h"
+#include <math.h>
+#include <string.h>
+
+#if defined(__SSE2__)
+    #include <emmintrin.h>
+#endif
+
+bool meshlet_covers(const MeshData *data) {
+    if (!data->header || !data->meshlets) return false;
+    for (uint32_t l = 0; l < data->header->lod_count; l++) {
+        if (data->header->lods[l].meshlet_count == 0) return false;
+    }
+    return true;
+}
+
+MeshletView meshlet_view(const Frustum *frustum, HMM_Vec3 eye, HMM_Mat4 world) {
+    // The upper 3x3 is a rotation times a per-axis scale. A plane transforms
+    // by the transpose of the point transform; normalizing each one by its
+    // own normal's length keeps sphere tests in model units whatever the
+    // scale. Facing survives the transform, so the eye goes back by the
+    // inverse: each column over its squared length.
+    HMM_Vec3 x = world.Columns[0].XYZ;
+    HMM_Vec3 y = world.Columns[1].XYZ;
+    HMM_Vec3 z = world.Columns[2].XYZ;
+    HMM_Vec3 t = world.Columns[3].XYZ;
+
+    MeshletView view = { .inside = false };
+    for (int p = 0; p < FRUSTUM_PLANE_COUNT; p++) {
+        HMM_Vec4 plane = frustum->planes[p];
+        HMM_Vec3 n     = HMM_V3(HMM_DotV3(x, plane.XYZ), HMM_DotV3(y, plane.XYZ), HMM_DotV3(z, plane.XYZ));
+        float    len   = HMM_LenV3(n);
+        view.frustum.planes[p] = HMM_MulV4F(HMM_V4V(n, HMM_DotV3(t, plane.XYZ) + plane.W),
+                                            len > 0.0f ? 1.0f / len : 1.0f);
+    }
+    HMM_Vec3 d   = HMM_SubV3(eye, t);
+    float    sx2 = HMM_DotV3(x, x);
+    float    sy2 = HMM_DotV3(y, y);
+    float    sz2 = HMM_DotV3(z, z);
+    view.eye = HMM_V3(sx2 > 0.0f ? HMM_DotV3(x, d) / sx2 : 0.0f,
+                      sy2 > 0.0f ? HMM_DotV3(y, d) / sy2 : 0.0f,
+                      sz2 > 0.0f ? HMM_DotV3(z, d) / sz2 : 0.0f);
+    return view;
+}
+
+bool meshlet_visible(const MeshletView *view, const Meshlet *meshlet) {
+    HMM_Vec3 center = HMM_V3(meshlet->center[0], meshlet->center[1], meshlet->center[2]);
+    if (!view->inside && !frustum_test_sphere(&view->frustum, center, meshlet->radius)) return false;
+
+    HMM_Vec3 axis = HMM_V3(meshlet->cone_axis[0], meshlet->cone_axis[1], meshlet->cone_axis[2]);
+    HMM_Vec3 to   = HMM_SubV3(center, view->eye);
+    return HMM_DotV3(to, axis) < meshlet->cone_cutoff * HMM_LenV3(to) + meshlet->radius;
+}
+
+// Bit k set if meshlets[first + k] is visible, for up to four meshlets
+// before end. Both passes of meshlet_cull() go through here, so they agree.
+static uint32_t visible_mask(const MeshletView *view, const Meshlet *meshlets, uint32_t first, uint32_t end) {
+#if defined(__SSE2__)
+    if (first + 4 <= end) {
+        const Meshlet *m = meshlets + first;
+        __m128 cx = _mm_setr_ps(m[0].center[0], m[1].center[0], m[2].center[0], m[3].center[0]);
+        __m128 cy = _mm_setr_ps(m[0].center[1], m[1].center[1], m[2].center[1], m[3].center[1]);
+        __m128 cz = _mm_setr_ps(m[0].center[2], m[1].center[2], m[2].center[2], m[3].center[2]);
+        __m128 r  = _mm_setr_ps(m[0].radius, m[1].radius, m[2].radius, m[3].radius);
+
+        // Lanes stay set while the meshlet is not fully outside any plane
+        __m128 keep = _mm_castsi128_ps(_mm_set1_epi32(-1));
+        if (!view->inside) {
+            __m128 nr = _mm_sub_ps(_mm_setzero_ps(), r);
+            for (int p = 0; p < FRUSTUM_PLANE_COUNT; p++) {
+                HMM_Vec4 pl = view->frustum.planes[p];
+                __m128   d  = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(pl.X), cx), _mm_mul_ps(_mm_set1_ps(pl.Y), cy)),
+                                         _mm_add_ps(_mm_mul_ps(_mm_set1_ps(pl.Z), cz), _mm_set1_ps(pl.W)));
+                keep = _mm_and_ps(keep, _mm_cmpge_ps(d, nr));
+            }
+        }
+
+        __m128 ax  = _mm_setr_ps(m[0].cone_axis[0], m[1].cone_axis[0], m[2].cone_axis[0], m[3].cone_axis[0]);
+        __m128 ay  = _mm_setr_ps(m[0].cone_axis[1], m[1].cone_axis[1], m[2].cone_axis[1], m[3].cone_axis[1]);
+        __m128 az  = _mm_setr_ps(m[0].cone_axis[2], m[1].cone_axis[2], m[2].cone_axis[2], m[3].cone_axis[2]);
+        __m128 cut = _mm_setr_ps(m[0].cone_cutoff, m[1].cone_cutoff, m[2].cone_cutoff, m[3].cone_cutoff);
+        __m128 tx  = _mm_sub_ps(cx, _mm_set1_ps(view->eye.X));
+        __m128 ty  = _mm_sub_ps(cy, _mm_set1_ps(view->eye.Y));
+        __m128 tz  = _mm_sub_ps(cz, _mm_set1_ps(view->eye.Z));
+        __m128 dot = _mm_add_ps(_mm_add_ps(_mm_mul_ps(tx, ax), _mm_mul_ps(ty, ay)), _mm_mul_ps(tz, az));
+        __m128 len = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(tx, tx), _mm_mul_ps(ty, ty)), _mm_mul_ps(tz, tz)));
+        keep = _mm_and_ps(keep, _mm_cmplt_ps(dot, _mm_add_ps(_mm_mul_ps(cut, len), r)));
+        return (uint32_t)_mm_movemask_ps(keep);
+    }
+#endif
+    uint32_t mask = 0;
+    for (uint32_t i = first; i < end && i < first + 4; i++) {
+        if (meshlet_visible(view, &meshlets[i])) mask |= 1u << (i - first);
+    }
+    return mask;
+}
+
+uint32_t meshlet_cull(const MeshData *data, uint32_t lod, const MeshletView *view, void *out, uint32_t *culled) {
+    const MeshHeader *h       = data->header;
+    const MeshLod    *l       = &h->lods[lod];
+    const uint8_t    *indices = data->indices;
+    uint8_t          *dst     = out;
+    uint32_t          count   = 0;
+    uint32_t          end     = l->first_meshlet + l->meshlet_count;
+
+    // Tests are cheap next to copies, so find out what would go first
+    uint32_t dropped = 0, dropped_meshlets = 0;
+    for (uint32_t i = l->first_meshlet; i < end; i += 4) {
+        uint32_t mask = visible_mask(view, data->meshlets, i, end);
+        for (uint32_t k = 0; k < 4 && i + k < end; k++) {
+            if (mask & (1u << k)) continue;
+            dropped += data->meshlets[i + k].index_count;
+            dropped_meshlets++;
+        }
+    }
+    if ((float)dropped < MESHLET_MIN_CULLED * (float)l->index_count) return MESHLET_CULL_NONE;
+    *culled += dropped_meshlets;
+    if (dropped == l->index_count) return 0;
+
+    for (uint32_t i = l->first_meshlet; i < end; i += 4) {
+        uint32_t mask = visible_mask(view, data->meshlets, i, end);
+        while (mask) {
+            const Meshlet *m = &data->meshlets[i + (uint32_t)__builtin_ctz(mask)];
+            mask &= mask - 1;
+            memcpy(dst + (size_t)count * h->index_size, indices + (size_t)m->first_index * h->index_size,
+                   (size_t)m->index_count * h->index_size);
+            count += m->index_count;
+        }
+    }
+    return count;
+}
@@ -0,0 +1,282 @@
+#include "occlusion.h"
+#include "job.h"
+#include <float.h>
+#include <math.h>
+#include <stdlib.h>
+
+#if defined(__SSE2__)
+    #include <emmintrin.h>
+#endif
+
+// Corners closer to the camera plane than this (in clip w) make a box
+// untestable, so it counts as visible
+#define OCCLUSION_MIN_W 1e-5f
+
+// Unlike fminf/fmaxf these compile to single instructions without
+// -ffast-math, which matters in the pyramid build
+static inline float min2(float a, float b) { return a < b ? a : b; }
+static inline float max2(float a, float b) { return a > b ? a : b; }
+
+struct OcclusionTri {
+    float   ea[3], eb[3], ec[3];   // edge functions, >= 0 inside
+    float   za, zb, zc;            // window depth plane
+    int32_t min_x, min_y, max_x, max_y;
+};
+
+bool occlusion_init(Occlusion *o, uint32_t width, uint32_t height) {
+    *o = (Occlusion){ .width = (width + 3) & ~3u, .height = height };
+    if (o->width == 0 || o->height == 0) return false;
+
+    uint32_t w = o->width, h = o->height;
+    for (uint32_t l = 0; l < OCCLUSION_MAX_LEVELS; l++) {
+        o->level_width[l]  = w;
+        o->level_height[l] = h;
+        o->min_depth[l]    = aligned_alloc(16, ((size_t)w * h * sizeof(float) + 15) & ~(size_t)15);
+        o->max_depth[l]    = l == 0 ? o->min_depth[0] : malloc((size_t)w * h * sizeof(float));
+        o->level_count     = l + 1;
+        if (!o->min_depth[l] || !o->max_depth[l]) {
+            occlusion_free(o);
+            return false;
+        }
+        if (w == 1 && h == 1) break;
+        w = (w + 1) / 2;
+        h = (h + 1) / 2;
+    }
+    return true;
+}
+
+void occlusion_free(Occlusion *o) {
+    for (uint32_t l = 0; l < o->level_count; l++) {
+        free(o->min_depth[l]);
+        if (l > 0) free(o->max_depth[l]);
+    }
+    free(o->tris);
+    *o = (Occlusion){0};
+}
+
+void occlusion_begin(Occlusion *o, HMM_Mat4 view_proj) {
+    o->view_proj = view_proj;
+    o->tri_count = 0;
+}
+
+// Returns false only if out of memory
+static bool setup_triangle(Occlusion *o, const HMM_Vec4 clip[3]) {
+    float sx[3], sy[3], sz[3];
+    for (int i = 0; i < 3; i++) {
+        float inv_w = 1.0f / clip[i].W;
+        sx[i] = (clip[i].X * inv_w * 0.5f + 0.5f) * (float)o->width;
+        sy[i] = (0.5f - clip[i].Y * inv_w * 0.5f) * (float)o->height;
+        sz[i] = clip[i].Z * inv_w * 0.5f + 0.5f;
+    }
+
+    // y points down, so counter-clockwise front faces have negative area
+    float area = (sx[1] - sx[0]) * (sy[2] - sy[0]) - (sy[1] - sy[0]) * (sx[2] - sx[0]);
+    if (!(area < 0.0f)) return true;
+    area = -area;
+
+    int32_t min_x = (int32_t)ceilf(min2(sx[0], min2(sx[1], sx[2])) - 0.5f);
+    int32_t max_x = (int32_t)floorf(max2(sx[0], max2(sx[1], sx[2])) - 0.5f);
+    int32_t min_y = (int32_t)ceilf(min2(sy[0], min2(sy[1], sy[2])) - 0.5f);
+    int32_t max_y = (int32_t)floorf(max2(sy[0], max2(sy[1], sy[2])) - 0.5f);
+    if (min_x < 0) min_x = 0;
+    if (min_y < 0) min_y = 0;
+    if (max_x > (int32_t)o->width - 1)  max_x = (int32_t)o->width - 1;
+    if (max_y > (int32_t)o->height - 1) max_y = (int32_t)o->height - 1;
+    if (min_x > max_x || min_y > max_y) return true;
+
+    if (o->tri_count == o->tri_capacity) {
+        uint32_t      capacity = o->tri_capacity ? o->tri_capacity * 2 : 256;
+        OcclusionTri *tris     = realloc(o->tris, capacity * sizeof(OcclusionTri));
+        if (!tris) return false;
+        o->tris         = tris;
+        o->tri_capacity = capacity;
+    }
+    OcclusionTri *tri = &o->tris[o->tri_count++];
+    *tri = (OcclusionTri){ .min_x = min_x, .min_y = min_y, .max_x = max_x, .max_y = max_y };
+
+    // Edge i is opposite vertex i (after swapping 1 and 2 to make the area
+    // positive), relative to the bounding box's first pixel centre
+    static const int order[3] = { 0, 2, 1 };
+    float ref_x = (float)min_x + 0.5f, ref_y = (float)min_y + 0.5f;
+    for (int i = 0; i < 3; i++) {
+        int   a  = order[(i + 1) % 3], b = order[(i + 2) % 3];
+        float ea = sy[a] - sy[b];
+        float eb = sx[b] - sx[a];
+        float ec = eb * (ref_y - sy[a]) + ea * (ref_x - sx[a]);
+        float z  = sz[order[i]] / area;
+        tri->ea[i] = ea;
+        tri->eb[i] = eb;
+        tri->ec[i] = ec;
+        tri->za   += ea * z;
+        tri->zb   += eb * z;
+        tri->zc   += ec * z;
+    }
+    return true;
+}
+
+bool occlusion_add_occluder(Occlusion *o, const MeshVertex *vertices, uint32_t vertex_count,
+                            const void *indices, uint32_t index_size, uint32_t index_count, HMM_Mat4 world) {
+    HMM_Mat4        mvp       = HMM_MulM4(o->view_proj, world);
+    const uint16_t *indices16 = indices;
+    const uint32_t *indices32 = indices;
+    bool            ok        = true;
+    for (uint32_t i = 0; i + 3 <= index_count; i += 3) {
+        HMM_Vec4 clip[3];
+        bool     usable = true;
+        for (int k = 0; k < 3; k++) {
+            uint32_t idx = index_size == 2 ? indices16[i + k] : indices32[i + k];
+            if (idx >= vertex_count) idx = 0;
+            const float *p = vertices[idx].position;
+            clip[k] = HMM_MulM4V4(mvp, HMM_V4(p[0], p[1], p[2], 1.0f));
+            usable &= clip[k].Z >= -clip[k].W && clip[k].W > OCCLUSION_MIN_W;
+        }
+        if (!usable) continue;
+        ok &= setup_triangle(o, clip);
+    }
+    return ok;
+}
+
+// Rasterize the rows [y0, y1] of tri, keeping the nearest depth
+static void raster_rows(Occlusion *o, const OcclusionTri *tri, int32_t y0, int32_t y1) {
+    int32_t min_x = tri->min_x & ~3;
+    for (int32_t y = y0; y <= y1; y++) {
+        float  dy  = (float)(y - tri->min_y);
+        float *row = o->min_depth[0] + (size_t)y * o->width;
+#if defined(__SSE2__)
+        __m128 lane = _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f);
+        __m128 zero = _mm_setzero_ps();
+        __m128 e_row[3], e_step[3];
+        for (int i = 0; i < 3; i++) {
+            e_row[i]  = _mm_set1_ps(tri->ec[i] + tri->eb[i] * dy);
+            e_step[i] = _mm_set1_ps(tri->ea[i]);
+        }
+        __m128 z_row  = _mm_set1_ps(tri->zc + tri->zb * dy);
+        __m128 z_step = _mm_set1_ps(tri->za);
+        for (int32_t x = min_x; x <= tri->max_x; x += 4) {
+            __m128 dx     = _mm_add_ps(_mm_set1_ps((float)(x - tri->min_x)), lane);
+            __m128 inside = _mm_and_ps(
+                _mm_and_ps(_mm_cmpge_ps(_mm_add_ps(e_row[0], _mm_mul_ps(e_step[0], dx)), zero),
+                           _mm_cmpge_ps(_mm_add_ps(e_row[1], _mm_mul_ps(e_step[1], dx)), zero)),
+                _mm_cmpge_ps(_mm_add_ps(e_row[2], _mm_mul_ps(e_step[2], dx)), zero));
+            __m128 d = _mm_load_ps(row + x);
+            __m128 z = _mm_min_ps(d, _mm_add_ps(z_row, _mm_mul_ps(z_step, dx)));
+            _mm_store_ps(row + x, _mm_or_ps(_mm_and_ps(inside, z), _mm_andnot_ps(inside, d)));
+        }
+#else
+        for (int32_t x = tri->min_x; x <= tri->max_x; x++) {
+            float dx = (float)(x - tri->min_x);
+            if (tri->ec[0] + tri->ea[0] * dx + tri->eb[0] * dy < 0.0f ||
+                tri->ec[1] + tri->ea[1] * dx + tri->eb[1] * dy < 0.0f ||
+                tri->ec[2] + tri->ea[2] * dx + tri->eb[2] * dy < 0.0f) {
+                continue;
+            }
+            float z = tri->zc + tri->za * dx + tri->zb * dy;
+            if (z < row[x]) row[x] = z;
+        }
+        (void)min_x;
+#endif
+    }
+}
+
+// Clear a band of rows to far, then rasterize every occluder over it
+static void raster_bands(void *data, uint32_t begin, uint32_t end) {
+    Occlusion *o = data;
+    for (uint32_t b = begin; b < end; b++) {
+        int32_t y0 = (int32_t)(b * OCCLUSION_BAND_ROWS);
+        int32_t y1 = y0 + OCCLUSION_BAND_ROWS - 1;
+        if (y1 > (int32_t)o->height - 1) y1 = (int32_t)o->height - 1;
+
+        float *rows = o->min_depth[0] + (size_t)y0 * o->width;
+        for (size_t i = 0; i < (size_t)(y1 - y0 + 1) * o->width; i++) rows[i] = 1.0f;
+        for (uint32_t t = 0; t < o->tri_count; t++) {
+            const OcclusionTri *tri = &o->tris[t];
+            int32_t ya = tri->min_y > y0 ? tri->min_y : y0;
+            int32_t yb = tri->max_y < y1 ? tri->max_y : y1;
+            if (ya <= yb) raster_rows(o, tri, ya, yb);
+        }
+    }
+}
+
+void occlusion_end(Occlusion *o) {
+    uint32_t bands = (o->height + OCCLUSION_BAND_ROWS - 1) / OCCLUSION_BAND_ROWS;
+    job_parallel_for(bands, 1, raster_bands, o);
+
+    // Each texel holds the nearest and farthest depth of the up to 2x2
+    // texels below it
+    for (uint32_t l = 1; l < o->level_count; l++) {
+        uint32_t     cw = o->level_width[l - 1], ch = o->level_height[l - 1];
+        uint32_t     w  = o->level_width[l],     h  = o->level_height[l];
+        const float *cmin = o->min_depth[l - 1], *cmax = o->max_depth[l - 1];
+        for (uint32_t y = 0; y < h; y++) {
+            uint32_t y0 = y * 2, y1 = y0 + 1 < ch ? y0 + 1 : y0;
+            for (uint32_t x = 0; x < w; x++) {
+                uint32_t x0 = x * 2, x1 = x0 + 1 < cw ? x0 + 1 : x0;
+                o->min_depth[l][y * w + x] = min2(min2(cmin[y0 * cw + x0], cmin[y0 * cw + x1]),
+                                                  min2(cmin[y1 * cw + x0], cmin[y1 * cw + x1]));
+                o->max_depth[l][y * w + x] = max2(max2(cmax[y0 * cw + x0], cmax[y0 * cw + x1]),
+                                                  max2(cmax[y1 * cw + x0], cmax[y1 * cw + x1]));
+            }
+        }
+    }
+}
+
+// Whether something at depth z within the level 0 rectangle [x0, x1] x
+// [y0, y1] can show through texel (tx, ty) of level. Descends only where
+// the texel's depth range straddles z.
+static bool texel_visible(const Occlusion *o, uint32_t level, uint32_t tx, uint32_t ty,
+                          uint32_t x0, uint32_t y0, uint32_t x1, uint32_t y1, float z) {
+    uint32_t i = ty * o->level_width[level] + tx;
+    if (z <= o->min_depth[level][i]) return true;
+    if (z > o->max_depth[level][i])  return false;
+
+    uint32_t l = level - 1;
+    for (uint32_t cy = ty * 2; cy <= ty * 2 + 1 && cy < o->level_height[l]; cy++) {
+        if (cy < y0 >> l || cy > y1 >> l) continue;
+        for (uint32_t cx = tx * 2; cx <= tx * 2 + 1 && cx < o->level_width[l]; cx++) {
+            if (cx < x0 >> l || cx > x1 >> l) continue;
+            if (texel_visible(o, l, cx, cy, x0, y0, x1, y1, z)) return true;
+        }
+    }
+    return false;
+}
+
+bool occlusion_test_box(const Occlusion *o, HMM_Vec3 min, HMM_Vec3 max) {
+    float min_x = FLT_MAX, min_y = FLT_MAX, min_z = FLT_MAX;
+    float max_x = -FLT_MAX, max_y = -FLT_MAX;
+    for (int c = 0; c < 8; c++) {
+        HMM_Vec4 p = HMM_MulM4V4(o->view_proj, HMM_V4(c & 1 ? max.X : min.X, c & 2 ? max.Y : min.Y,
+                                                      c & 4 ? max.Z : min.Z, 1.0f));
+        if (p.W <= OCCLUSION_MIN_W) return true;
+        float inv_w = 1.0f / p.W;
+        min_x = min2(min_x, p.X * inv_w);
+        max_x = max2(max_x, p.X * inv_w);
+        min_y = min2(min_y, p.Y * inv_w);
+        max_y = max2(max_y, p.Y * inv_w);
+        min_z = min2(min_z, p.Z * inv_w);
+    }
+    if (min_z < -1.0f) return true;
+
+    // Level 0 pixels the box's screen rectangle touches
+    float fx0 = (min_x * 0.5f + 0.5f) * (float)o->width;
+    float fx1 = (max_x * 0.5f + 0.5f) * (float)o->width;
+    float fy0 = (0.5f - max_y * 0.5f) * (float)o->height;
+    float fy1 = (0.5f - min_y * 0.5f) * (float)o->height;
+    if (fx1 < 0.0f || fy1 < 0.0f || fx0 >= (float)o->width || fy0 >= (float)o->height) return true;
+    uint32_t x0 = fx0 > 0.0f ? (uint32_t)fx0 : 0;
+    uint32_t y0 = fy0 > 0.0f ? (uint32_t)fy0 : 0;
+    uint32_t x1 = fx1 < (float)(o->width - 1)  ? (uint32_t)fx1 : o->width - 1;
+    uint32_t y1 = fy1 < (float)(o->height - 1) ? (uint32_t)fy1 : o->height - 1;
+
+    // Start on the level where the rectangle spans at most 2x2 texels
+    uint32_t extent = (x1 - x0 > y1 - y0 ? x1 - x0 : y1 - y0) + 1;
+    uint32_t level  = 0;
+    while ((1u << level) < extent && level + 1 < o->level_count) level++;
+
+    float z = min_z * 0.5f + 0.5f;
+    for (uint32_t ty = y0 >> level; ty <= y1 >> level; ty++) {
+        for (uint32_t tx = x0 >> level; tx <= x1 >> level; tx++) {
+            if (texel_visible(o, level, tx, ty, x0, y0, x1, y1, z)) return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,83 @@
+#include "pool.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define POOL_GENERATION_MASK (UINT32_MAX >> POOL_INDEX_BITS)
+
+bool pool_init(Pool *pool, uint32_t capacity, uint32_t item_size) {
+    if (capacity > POOL_MAX_CAPACITY) {
+        *pool = (Pool){0};
+        return false;
+    }
+    *pool = (Pool){ .capacity = capacity, .item_size = item_size };
+
+    // Slot arrays have an unused entry 0 so slots index them directly
+    pool->items      = item_size > 0 ? malloc((size_t)capacity * item_size) : NULL;
+    pool->handles    = malloc((size_t)capacity * sizeof(uint32_t));
+    pool->dense      = malloc(((size_t)capacity + 1) * sizeof(uint32_t));
+    pool->generation = calloc((size_t)capacity + 1, sizeof(uint32_t));
+    pool->free_slots = malloc((size_t)capacity * sizeof(uint32_t));
+    if ((item_size > 0 && !pool->items) || !pool->handles || !pool->dense || !pool->generation ||
+        !pool->free_slots) {
+        pool_free(pool);
+        return false;
+    }
+
+    // Hand out low slots first
+    for (uint32_t i = 0; i < capacity; i++) pool->free_slots[i] = capacity - i;
+    pool->free_count = capacity;
+    return true;
+}
+
+void pool_free(Pool *pool) {
+    free(pool->items);
+    free(pool->handles);
+    free(pool->dense);
+    free(pool->generation);
+    free(pool->free_slots);
+    *pool = (Pool){0};
+}
+
+uint32_t pool_alloc(Pool *pool) {
+    if (pool->free_count == 0) return POOL_INVALID;
+
+    uint32_t slot   = pool->free_slots[--pool->free_count];
+    uint32_t index  = pool->count++;
+    uint32_t handle = pool->generation[slot] << POOL_INDEX_BITS | slot;
+    pool->dense[slot]    = index;
+    pool->handles[index] = handle;
+    if (pool->item_size > 0) memset(pool_at(pool, index), 0, pool->item_size);
+    return handle;
+}
+
+uint32_t pool_index(const Pool *pool, uint32_t handle) {
+    uint32_t slot = handle & POOL_INDEX_MASK;
+    if (slot == 0 || slot > pool->capacity) return UINT32_MAX;
+    uint32_t index = pool->dense[slot];
+    return index < pool->count && pool->handles[index] == handle ? index : UINT32_MAX;
+}
+
+void *pool_get(const Pool *pool, uint32_t handle) {
+    uint32_t index = pool_index(pool, handle);
+    return index != UINT32_MAX && pool->item_size > 0 ? pool_at(pool, index) : NULL;
+}
+
+bool pool_release(Pool *pool, uint32_t handle) {
+    uint32_t index = pool_index(pool, handle);
+    if (index == UINT32_MAX) return false;
+
+    uint32_t last = --pool->count;
+    if (index != last) {
+        uint32_t moved = pool->handles[last];
+        pool->handles[index]                 = moved;
+        pool->dense[moved & POOL_INDEX_MASK] = index;
+        if (pool->item_size > 0) memcpy(pool_at(pool, index), pool_at(pool, last), pool->item_size);
+    }
+
+    // Generations wrap; a handle kept across 2^12 reuses of its slot would
+    // resolve again
+    uint32_t slot = handle & POOL_INDEX_MASK;
+    pool->generation[slot]               = (pool->generation[slot] + 1) & POOL_GENERATION_MASK;
+    pool->free_slots[pool->free_count++] = slot;
+    return true;
+}
@@ -0,0 +1,147 @@
+#include "profile.h"
+#include "sokol_time.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define PROFILE_RING_MASK (PROFILE_RING_SIZE - 1)
+
+typedef struct {
+    ProfileEvent  events[PROFILE_RING_SIZE];
+    atomic_ullong written;                   // events ever recorded
+    const char   *thread_name;
+
+    // Open scopes, only touched by the owning thread
+    const char   *open_name[PROFILE_MAX_DEPTH];
+    uint64_t      open_start[PROFILE_MAX_DEPTH];
+    uint32_t      depth;
+    bool          released;                  // owner exited; guarded by lock
+} ProfileRing;
+
+static struct {
+    ProfileRing    *rings[PROFILE_MAX_THREADS];
+    atomic_uint     ring_count;
+    atomic_bool     disabled;
+    pthread_mutex_t lock;                    // claiming and releasing rings
+} profile = { .lock = PTHREAD_MUTEX_INITIALIZER };
+
+static _Thread_local ProfileRing *local_ring;
+static _Thread_local bool         local_full;
+
+// Slow path, once per thread: reuse a released ring, else add one
+static ProfileRing *ring(void) {
+    if (local_ring || local_full) return local_ring;
+
+    pthread_mutex_lock(&profile.lock);
+    uint32_t     count = atomic_load(&profile.ring_count);
+    ProfileRing *r     = NULL;
+    for (uint32_t t = 0; t < count && !r; t++) {
+        if (profile.rings[t]->released) r = profile.rings[t];
+    }
+    if (r) {
+        r->released    = false;
+        r->thread_name = NULL;
+        r->depth       = 0;
+    } else if (count < PROFILE_MAX_THREADS && (r = calloc(1, sizeof(ProfileRing))) != NULL) {
+        atomic_init(&r->written, 0);
+        profile.rings[count] = r;
+        atomic_store(&profile.ring_count, count + 1);
+    }
+    pthread_mutex_unlock(&profile.lock);
+
+    local_ring = r;
+    local_full = !r;
+    return r;
+}
+
+void profile_thread_release(void) {
+    ProfileRing *r = local_ring;
+    local_ring = NULL;
+    local_full = false;
+    if (!r) return;
+    pthread_mutex_lock(&profile.lock);
+    r->released = true;
+    pthread_mutex_unlock(&profile.lock);
+}
+
+void profile_record(const char *name, uint64_t start, uint64_t end) {
+    if (atomic_load_explicit(&profile.disabled, memory_order_relaxed)) return;
+    ProfileRing *r = ring();
+    if (!r) return;
+
+    unsigned long long n = atomic_load_explicit(&r->written, memory_order_relaxed);
+    r->events[n & PROFILE_RING_MASK] = (ProfileEvent){ .name = name, .start = start, .end = end };
+    atomic_store_explicit(&r->written, n + 1, memory_order_release);
+}
+
+void profile_begin(const char *name) {
+    if (atomic_load_explicit(&profile.disabled, memory_order_relaxed)) return;
+    ProfileRing *r = ring();
+    if (!r) return;
+
+    // Too deep: still counted so the matching end pops correctly
+    if (r->depth < PROFILE_MAX_DEPTH) {
+        r->open_name[r->depth]  = name;
+        r->open_start[r->depth] = stm_now();
+    }
+    r->depth++;
+}
+
+void profile_end(void) {
+    ProfileRing *r = local_ring;
+    if (!r || r->depth == 0) return;
+
+    uint32_t d = --r->depth;
+    if (d < PROFILE_MAX_DEPTH) profile_record(r->open_name[d], r->open_start[d], stm_now());
+}
+
+void profile_thread_name(const char *name) {
+    ProfileRing *r = ring();
+    if (r) r->thread_name = name;
+}
+
+void profile_set_enabled(bool enabled) {
+    atomic_store(&profile.disabled, !enabled);
+}
+
+bool profile_export_chrome(const char *path) {
+    FILE *f = fopen(path, "w");
+    if (!f) return false;
+
+    uint32_t count = atomic_load(&profile.ring_count);
+    if (count > PROFILE_MAX_THREADS) count = PROFILE_MAX_THREADS;
+
+    // Timestamps relative to the oldest buffered event
+    uint64_t base = UINT64_MAX;
+    for (uint32_t t = 0; t < count; t++) {
+        const ProfileRing *r = profile.rings[t];
+        if (!r) continue;
+        unsigned long long n = atomic_load_explicit(&r->written, memory_order_acquire);
+        for (unsigned long long i = n > PROFILE_RING_SIZE ? n - PROFILE_RING_SIZE : 0; i < n; i++) {
+            uint64_t start = r->events[i & PROFILE_RING_MASK].start;
+            if (start < base) base = start;
+        }
+    }
+
+    fprintf(f, "{\"traceEvents\":[\n");
+    bool first = true;
+    for (uint32_t t = 0; t < count; t++) {
+        const ProfileRing *r = profile.rings[t];
+        if (!r) continue;
+        if (r->thread_name) {
+            fprintf(f, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%u,\"args\":{\"name\":\"%s\"}}",
+                    first ? "" : ",\n", t, r->thread_name);
+            first = false;
+        }
+        unsigned long long n = atomic_load_explicit(&r->written, memory_order_acquire);
+        for (unsigned long long i = n > PROFILE_RING_SIZE ? n - PROFILE_RING_SIZE : 0; i < n; i++) {
+            const ProfileEvent *e = &r->events[i & PROFILE_RING_MASK];
+            fprintf(f, "%s{\"name\":\"%s\",\"ph\":\"X\",\"pid\":0,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                    first ? "" : ",\n", e->name, t, stm_us(e->start - base), stm_us(stm_diff(e->end, e->start)));
+            first = false;
+        }
+    }
+    fprintf(f, "\n]}\n");
+    return fclose(f) == 0;
+}
@@ -0,0 +1,406 @@
+#include "raster.h"
+#include "job.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__SSE2__)
+    #include <emmintrin.h>
+#endif
+
+// Screen positions snap to 1/RASTER_SUBPIXEL of a pixel. Edge values at
+// pixel centres are then multiples of 1/RASTER_SUBPIXEL^2, so a bias of half
+// that step turns >= 0 into > 0 for the fill rule without moving any edge.
+#define RASTER_SUBPIXEL  16.0f
+#define RASTER_EDGE_BIAS (0.5f / (RASTER_SUBPIXEL * RASTER_SUBPIXEL))
+
+// A triangle clipped against six planes has at most nine vertices
+#define RASTER_MAX_CLIPPED 9
+
+// Attributes are interpolated through planes a * dx + b * dy + c, with dx
+// and dy counted in pixels from the bounding box's first pixel
+enum { PLANE_Z, PLANE_INV_W, PLANE_U, PLANE_V, PLANE_COUNT };
+
+struct RasterTri {
+    float                ea[3], eb[3], ec[3];   // edge functions, >= 0 inside
+    float                pa[PLANE_COUNT], pb[PLANE_COUNT], pc[PLANE_COUNT];
+    int32_t              min_x, min_y, max_x, max_y;
+    const RasterTexture *tex;
+};
+
+// Clip-space vertex carrying the texture coordinates
+typedef struct {
+    HMM_Vec4 pos;
+    float    u, v;
+} ClipVertex;
+
+static size_t align_up(size_t n, size_t align) {
+    return (n + align - 1) & ~(align - 1);
+}
+
+bool raster_init(Raster *r, uint32_t width, uint32_t height) {
+    *r = (Raster){
+        .width   = width,
+        .height  = height,
+        .tiles_x = (width  + RASTER_TILE_SIZE - 1) / RASTER_TILE_SIZE,
+        .tiles_y = (height + RASTER_TILE_SIZE - 1) / RASTER_TILE_SIZE,
+    };
+    r->stride    = r->tiles_x * RASTER_TILE_SIZE;
+    size_t count = (size_t)r->stride * r->tiles_y * RASTER_TILE_SIZE;
+    r->color     = aligned_alloc(64, align_up(count * sizeof(uint32_t), 64));
+    r->depth     = aligned_alloc(64, align_up(count * sizeof(float), 64));
+    r->bins      = calloc((size_t)r->tiles_x * r->tiles_y, sizeof(RasterBin));
+    if (width == 0 || height == 0 || !r->color || !r->depth || !r->bins) {
+        raster_free(r);
+        return false;
+    }
+    return true;
+}
+
+void raster_free(Raster *r) {
+    if (r->bins) {
+        for (uint32_t t = 0; t < r->tiles_x * r->tiles_y; t++) free(r->bins[t].tris);
+    }
+    free(r->bins);
+    free(r->color);
+    free(r->depth);
+    free(r->tris);
+    free(r->clip);
+    *r = (Raster){0};
+}
+
+void raster_begin(Raster *r, uint32_t clear_color, float clear_depth) {
+    r->clear       = true;
+    r->clear_color = clear_color;
+    r->clear_depth = clear_depth;
+    r->tri_count   = 0;
+    r->stats       = (RasterStats){0};
+}
+
+// Clip planes as (x, y, z, w) coefficients: near and far, then the guard band
+static const float clip_planes[][4] = {
+    {  0.0f,  0.0f,  1.0f, 1.0f },
+    {  0.0f,  0.0f, -1.0f, 1.0f },
+    {  1.0f,  0.0f,  0.0f, RASTER_GUARD_BAND },
+    { -1.0f,  0.0f,  0.0f, RASTER_GUARD_BAND },
+    {  0.0f,  1.0f,  0.0f, RASTER_GUARD_BAND },
+    {  0.0f, -1.0f,  0.0f, RASTER_GUARD_BAND },
+};
+#define CLIP_PLANE_COUNT (int)(sizeof(clip_planes) / sizeof(clip_planes[0]))
+
+static float plane_distance(int plane, HMM_Vec4 p) {
+    const float *c = clip_planes[plane];
+    return c[0] * p.X + c[1] * p.Y + c[2] * p.Z + c[3] * p.W;
+}
+
+// Bit per plane the vertex is outside of; view bits use the real frustum
+// sides so triangles fully off-screen are rejected before any clipping
+static uint32_t guard_outcode(HMM_Vec4 p) {
+    uint32_t code = 0;
+    for (int i = 0; i < CLIP_PLANE_COUNT; i++) {
+        if (plane_distance(i, p) < 0.0f) code |= 1u << i;
+    }
+    return code;
+}
+
+static uint32_t view_outcode(HMM_Vec4 p) {
+    return (p.X < -p.W) << 0 | (p.X > p.W) << 1 | (p.Y < -p.W) << 2 |
+           (p.Y > p.W) << 3 | (p.Z < -p.W) << 4 | (p.Z > p.W) << 5;
+}
+
+// Sutherland-Hodgman against every plane in mask. Returns the vertex count.
+static int clip_polygon(ClipVertex *poly, int count, uint32_t mask) {
+    ClipVertex tmp[RASTER_MAX_CLIPPED];
+    for (int p = 0; p < CLIP_PLANE_COUNT && count >= 3; p++) {
+        if (!(mask & (1u << p))) continue;
+        int n = 0;
+        for (int i = 0; i < count; i++) {
+            const ClipVertex *a = &poly[i];
+            const ClipVertex *b = &poly[(i + 1) % count];
+            float da = plane_distance(p, a->pos);
+            float db = plane_distance(p, b->pos);
+            if (da >= 0.0f) tmp[n++] = *a;
+            if ((da >= 0.0f) != (db >= 0.0f)) {
+                float t = da / (da - db);
+                tmp[n++] = (ClipVertex){
+                    .pos = HMM_LerpV4(a->pos, t, b->pos),
+                    .u   = a->u + (b->u - a->u) * t,
+                    .v   = a->v + (b->v - a->v) * t,
+                };
+            }
+        }
+        memcpy(poly, tmp, (size_t)n * sizeof(ClipVertex));
+        count = n;
+    }
+    return count;
+}
+
+static bool bin_push(RasterBin *bin, uint32_t tri) {
+    if (bin->count == bin->capacity) {
+        uint32_t  capacity = bin->capacity ? bin->capacity * 2 : 64;
+        uint32_t *tris     = realloc(bin->tris, capacity * sizeof(uint32_t));
+        if (!tris) return false;
+        bin->tris     = tris;
+        bin->capacity = capacity;
+    }
+    bin->tris[bin->count++] = tri;
+    return true;
+}
+
+// Project, cull and set up one clipped triangle, then bin it
+static bool setup_triangle(Raster *r, const ClipVertex *v0, const ClipVertex *v1, const ClipVertex *v2,
+                           const RasterTexture *tex) {
+    const ClipVertex *in[3] = { v0, v1, v2 };
+    float sx[3], sy[3], attr[3][PLANE_COUNT];
+    for (int i = 0; i < 3; i++) {
+        float inv_w = 1.0f / in[i]->pos.W;
+        sx[i] = roundf((in[i]->pos.X * inv_w * 0.5f + 0.5f) * r->width  * RASTER_SUBPIXEL) / RASTER_SUBPIXEL;
+        sy[i] = roundf((0.5f - in[i]->pos.Y * inv_w * 0.5f) * r->height * RASTER_SUBPIXEL) / RASTER_SUBPIXEL;
+        attr[i][PLANE_Z]     = in[i]->pos.Z * inv_w * 0.5f + 0.5f;
+        attr[i][PLANE_INV_W] = inv_w;
+        attr[i][PLANE_U]     = in[i]->u * inv_w;
+        attr[i][PLANE_V]     = in[i]->v * inv_w;
+    }
+
+    // With y pointing down, counter-clockwise front faces have negative
+    // area. Swap two vertices so edges are >= 0 inside.
+    float area = (sx[1] - sx[0]) * (sy[2] - sy[0]) - (sy[1] - sy[0]) * (sx[2] - sx[0]);
+    if (!(area < 0.0f)) return true;
+    int order[3] = { 0, 2, 1 };
+    area = -area;
+
+    float min_xf = fminf(sx[0], fminf(sx[1], sx[2])), max_xf = fmaxf(sx[0], fmaxf(sx[1], sx[2]));
+    float min_yf = fminf(sy[0], fminf(sy[1], sy[2])), max_yf = fmaxf(sy[0], fmaxf(sy[1], sy[2]));
+    int32_t min_x = (int32_t)ceilf(min_xf - 0.5f), max_x = (int32_t)floorf(max_xf - 0.5f);
+    int32_t min_y = (int32_t)ceilf(min_yf - 0.5f), max_y = (int32_t)floorf(max_yf - 0.5f);
+    if (min_x < 0) min_x = 0;
+    if (min_y < 0) min_y = 0;
+    if (max_x > (int32_t)r->width - 1)  max_x = (int32_t)r->width - 1;
+    if (max_y > (int32_t)r->height - 1) max_y = (int32_t)r->height - 1;
+    if (min_x > max_x || min_y > max_y) return true;
+
+    if (r->tri_count == r->tri_capacity) {
+        uint32_t   capacity = r->tri_capacity ? r->tri_capacity * 2 : 1024;
+        RasterTri *tris     = realloc(r->tris, capacity * sizeof(RasterTri));
+        if (!tris) return false;
+        r->tris         = tris;
+        r->tri_capacity = capacity;
+    }
+    uint32_t   index = r->tri_count++;
+    RasterTri *tri   = &r->tris[index];
+    *tri = (RasterTri){ .min_x = min_x, .min_y = min_y, .max_x = max_x, .max_y = max_y, .tex = tex };
+
+    // Edge i is opposite vertex i, evaluated relative to the first pixel
+    // centre of the bounding box
+    float ref_x = (float)min_x + 0.5f, ref_y = (float)min_y + 0.5f;
+    for (int i = 0; i < 3; i++) {
+        int   a = order[(i + 1) % 3], b = order[(i + 2) % 3];
+        float ea = sy[a] - sy[b];
+        float eb = sx[b] - sx[a];
+        float ec = eb * (ref_y - sy[a]) + ea * (ref_x - sx[a]);
+        // Top-left fill rule: pixels exactly on other edges belong to the
+        // neighbouring triangle
+        bool top_left = ea > 0.0f || (ea == 0.0f && eb > 0.0f);
+        tri->ea[i] = ea;
+        tri->eb[i] = eb;
+        tri->ec[i] = top_left ? ec : ec - RASTER_EDGE_BIAS;
+
+        // Barycentric weight i is edge i over the area
+        for (int p = 0; p < PLANE_COUNT; p++) {
+            float w = attr[order[i]][p] / area;
+            tri->pa[p] += ea * w;
+            tri->pb[p] += eb * w;
+            tri->pc[p] += ec * w;
+        }
+    }
+    r->stats.rasterized++;
+
+    for (int32_t ty = min_y / RASTER_TILE_SIZE; ty <= max_y / RASTER_TILE_SIZE; ty++) {
+        for (int32_t tx = min_x / RASTER_TILE_SIZE; tx <= max_x / RASTER_TILE_SIZE; tx++) {
+            if (!bin_push(&r->bins[(uint32_t)ty * r->tiles_x + (uint32_t)tx], index)) return false;
+            r->stats.bin_entries++;
+        }
+    }
+    return true;
+}
+
+bool raster_draw(Raster *r, const MeshVertex *vertices, uint32_t vertex_count,
+                 const void *indices, uint32_t index_size, uint32_t index_count,
+                 HMM_Mat4 mvp, const RasterTexture *tex) {
+    if (vertex_count > r->clip_capacity) {
+        HMM_Vec4 *clip = realloc(r->clip, vertex_count * sizeof(HMM_Vec4));
+        if (!clip) return false;
+        r->clip          = clip;
+        r->clip_capacity = vertex_count;
+    }
+    for (uint32_t i = 0; i < vertex_count; i++) {
+        const float *p = vertices[i].position;
+        r->clip[i] = HMM_MulM4V4(mvp, HMM_V4(p[0], p[1], p[2], 1.0f));
+    }
+
+    const uint16_t *indices16 = indices;
+    const uint32_t *indices32 = indices;
+    for (uint32_t i = 0; i + 3 <= index_count; i += 3) {
+        r->stats.triangles++;
+        uint32_t   idx[3];
+        ClipVertex poly[RASTER_MAX_CLIPPED];
+        for (int k = 0; k < 3; k++) {
+            idx[k] = index_size == 2 ? indices16[i + k] : indices32[i + k];
+            if (idx[k] >= vertex_count) idx[k] = 0;
+            poly[k] = (ClipVertex){ r->clip[idx[k]], vertices[idx[k]].uv[0], vertices[idx[k]].uv[1] };
+        }
+
+        if (view_outcode(poly[0].pos) & view_outcode(poly[1].pos) & view_outcode(poly[2].pos)) continue;
+        uint32_t clip = guard_outcode(poly[0].pos) | guard_outcode(poly[1].pos) | guard_outcode(poly[2].pos);
+        int count = clip ? clip_polygon(poly, 3, clip) : 3;
+        for (int k = 1; k + 1 < count; k++) {
+            if (!setup_triangle(r, &poly[0], &poly[k], &poly[k + 1], tex)) return false;
+        }
+    }
+    return true;
+}
+
+// a + (b - a) * t per channel, t in [0, 256]
+static uint32_t lerp_rgba(uint32_t a, uint32_t b, uint32_t t) {
+    uint32_t s  = 256 - t;
+    uint32_t rb = (((a & 0x00FF00FFu) * s + (b & 0x00FF00FFu) * t) >> 8) & 0x00FF00FFu;
+    uint32_t ag = (((a >> 8) & 0x00FF00FFu) * s + ((b >> 8) & 0x00FF00FFu) * t) & 0xFF00FF00u;
+    return rb | ag;
+}
+
+static uint32_t sample(const RasterTexture *tex, float u, float v) {
+    if (!tex) return 0xFFFFFFFFu;
+    if (tex->nearest) {
+        uint32_t x = (uint32_t)((u - floorf(u)) * (float)tex->width);
+        uint32_t y = (uint32_t)((v - floorf(v)) * (float)tex->height);
+        if (x >= tex->width)  x = tex->width - 1;
+        if (y >= tex->height) y = tex->height - 1;
+        return tex->texels[(size_t)y * tex->width + x];
+    }
+
+    float fx = (u - floorf(u)) * (float)tex->width  - 0.5f;
+    float fy = (v - floorf(v)) * (float)tex->height - 0.5f;
+    float x  = floorf(fx), y = floorf(fy);
+    uint32_t tx = (uint32_t)((fx - x) * 256.0f);
+    uint32_t ty = (uint32_t)((fy - y) * 256.0f);
+
+    // Repeat wrap; x and y start in [-1, size - 1]
+    int32_t x0 = (int32_t)x, y0 = (int32_t)y;
+    if (x0 < 0) x0 += (int32_t)tex->width;
+    if (y0 < 0) y0 += (int32_t)tex->height;
+    uint32_t x1 = (uint32_t)x0 + 1 < tex->width  ? (uint32_t)x0 + 1 : 0;
+    uint32_t y1 = (uint32_t)y0 + 1 < tex->height ? (uint32_t)y0 + 1 : 0;
+
+    const uint32_t *row0 = tex->texels + (size_t)y0 * tex->width;
+    const uint32_t *row1 = tex->texels + (size_t)y1 * tex->width;
+    return lerp_rgba(lerp_rgba(row0[x0], row0[x1], tx), lerp_rgba(row1[x0], row1[x1], tx), ty);
+}
+
+// Shade the part of tri inside the tile starting at (x0, y0)
+static void shade_triangle(Raster *r, const RasterTri *tri, int32_t x0, int32_t y0) {
+    int32_t min_x = tri->min_x > x0 ? tri->min_x : x0;
+    int32_t min_y = tri->min_y > y0 ? tri->min_y : y0;
+    int32_t max_x = tri->max_x < x0 + RASTER_TILE_SIZE - 1 ? tri->max_x : x0 + RASTER_TILE_SIZE - 1;
+    int32_t max_y = tri->max_y < y0 + RASTER_TILE_SIZE - 1 ? tri->max_y : y0 + RASTER_TILE_SIZE - 1;
+
+    // Whole 4-pixel steps; lanes outside the box fail the edge tests
+    min_x &= ~3;
+
+#if defined(__SSE2__)
+    __m128 lane = _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f);
+    __m128 zero = _mm_setzero_ps();
+    for (int32_t y = min_y; y <= max_y; y++) {
+        float   dy    = (float)(y - tri->min_y);
+        float  *depth = r->depth + (size_t)y * r->stride;
+        uint32_t *color = r->color + (size_t)y * r->stride;
+        __m128  e_row[3], p_row[PLANE_COUNT], e_step[3], p_step[PLANE_COUNT];
+        for (int i = 0; i < 3; i++) {
+            e_row[i]  = _mm_set1_ps(tri->ec[i] + tri->eb[i] * dy);
+            e_step[i] = _mm_set1_ps(tri->ea[i]);
+        }
+        for (int p = 0; p < PLANE_COUNT; p++) {
+            p_row[p]  = _mm_set1_ps(tri->pc[p] + tri->pb[p] * dy);
+            p_step[p] = _mm_set1_ps(tri->pa[p]);
+        }
+
+        for (int32_t x = min_x; x <= max_x; x += 4) {
+            __m128 dx = _mm_add_ps(_mm_set1_ps((float)(x - tri->min_x)), lane);
+            __m128 e0 = _mm_add_ps(e_row[0], _mm_mul_ps(e_step[0], dx));
+            __m128 e1 = _mm_add_ps(e_row[1], _mm_mul_ps(e_step[1], dx));
+            __m128 e2 = _mm_add_ps(e_row[2], _mm_mul_ps(e_step[2], dx));
+            __m128 inside = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(e0, zero), _mm_cmpge_ps(e1, zero)),
+                                       _mm_cmpge_ps(e2, zero));
+            if (!_mm_movemask_ps(inside)) continue;
+
+            __m128 z    = _mm_add_ps(p_row[PLANE_Z], _mm_mul_ps(p_step[PLANE_Z], dx));
+            __m128 d    = _mm_load_ps(depth + x);
+            __m128 pass = _mm_and_ps(inside, _mm_cmple_ps(z, d));
+            int    mask = _mm_movemask_ps(pass);
+            if (!mask) continue;
+            _mm_store_ps(depth + x, _mm_or_ps(_mm_and_ps(pass, z), _mm_andnot_ps(pass, d)));
+
+            // Perspective-correct texture coordinates
+            __m128 w = _mm_div_ps(_mm_set1_ps(1.0f),
+                                  _mm_add_ps(p_row[PLANE_INV_W], _mm_mul_ps(p_step[PLANE_INV_W], dx)));
+            float u[4], v[4];
+            _mm_storeu_ps(u, _mm_mul_ps(_mm_add_ps(p_row[PLANE_U], _mm_mul_ps(p_step[PLANE_U], dx)), w));
+            _mm_storeu_ps(v, _mm_mul_ps(_mm_add_ps(p_row[PLANE_V], _mm_mul_ps(p_step[PLANE_V], dx)), w));
+            while (mask) {
+                int l = __builtin_ctz((unsigned)mask);
+                color[x + l] = sample(tri->tex, u[l], v[l]);
+                mask &= mask - 1;
+            }
+        }
+    }
+#else
+    for (int32_t y = min_y; y <= max_y; y++) {
+        float     dy    = (float)(y - tri->min_y);
+        float    *depth = r->depth + (size_t)y * r->stride;
+        uint32_t *color = r->color + (size_t)y * r->stride;
+        for (int32_t x = min_x; x <= max_x; x++) {
+            float dx = (float)(x - tri->min_x);
+            if (tri->ec[0] + tri->ea[0] * dx + tri->eb[0] * dy < 0.0f ||
+                tri->ec[1] + tri->ea[1] * dx + tri->eb[1] * dy < 0.0f ||
+                tri->ec[2] + tri->ea[2] * dx + tri->eb[2] * dy < 0.0f) {
+                continue;
+            }
+            float z = tri->pc[PLANE_Z] + tri->pa[PLANE_Z] * dx + tri->pb[PLANE_Z] * dy;
+            if (!(z <= depth[x])) continue;
+            depth[x] = z;
+
+            float w = 1.0f / (tri->pc[PLANE_INV_W] + tri->pa[PLANE_INV_W] * dx + tri->pb[PLANE_INV_W] * dy);
+            float u = (tri->pc[PLANE_U] + tri->pa[PLANE_U] * dx + tri->pb[PLANE_U] * dy) * w;
+            float v = (tri->pc[PLANE_V] + tri->pa[PLANE_V] * dx + tri->pb[PLANE_V] * dy) * w;
+            color[x] = sample(tri->tex, u, v);
+        }
+    }
+#endif
+}
+
+static void shade_tiles(void *data, uint32_t begin, uint32_t end) {
+    Raster *r = data;
+    for (uint32_t t = begin; t < end; t++) {
+        int32_t x0 = (int32_t)(t % r->tiles_x) * RASTER_TILE_SIZE;
+        int32_t y0 = (int32_t)(t / r->tiles_x) * RASTER_TILE_SIZE;
+        if (r->clear) {
+            for (int32_t y = y0; y < y0 + RASTER_TILE_SIZE; y++) {
+                uint32_t *color = r->color + (size_t)y * r->stride + x0;
+                float    *depth = r->depth + (size_t)y * r->stride + x0;
+                for (int32_t x = 0; x < RASTER_TILE_SIZE; x++) {
+                    color[x] = r->clear_color;
+                    depth[x] = r->clear_depth;
+                }
+            }
+        }
+
+        RasterBin *bin = &r->bins[t];
+        for (uint32_t i = 0; i < bin->count; i++) shade_triangle(r, &r->tris[bin->tris[i]], x0, y0);
+        bin->count = 0;
+    }
+}
+
+void raster_end(Raster *r) {
+    job_parallel_for(r->tiles_x * r->tiles_y, 1, shade_tiles, r);
+    r->clear     = false;
+    r->tri_count = 0;
+}
@@ -0,0 +1,196 @@
+#include "scene.h"
+#include "transform.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SCENE_ALIGN 64
+
+// Clears *ok if the allocation fails
+static void *alloc_array(uint32_t capacity, size_t elem_size, bool *ok) {
+    // Cache-line aligned so vector loads never split a line
+    void *p = aligned_alloc(SCENE_ALIGN, ((size_t)capacity * elem_size + SCENE_ALIGN - 1) & ~(size_t)(SCENE_ALIGN - 1));
+    if (!p) {
+        *ok = false;
+        return NULL;
+    }
+    memset(p, 0, (size_t)capacity * elem_size);
+    return p;
+}
+
+bool scene_init(Scene *scene, uint32_t capacity) {
+    *scene = (Scene){0};
+    if (!pool_init(&scene->entities, capacity, 0)) return false;
+    bool ok = true;
+
+    // Padding is only iterated over, never handed out
+    capacity        = (capacity + SCENE_PAD - 1) / SCENE_PAD * SCENE_PAD;
+    scene->capacity = scene->entities.capacity;
+
+    scene->pos_x         = alloc_array(capacity, sizeof(float), &ok);
+    scene->pos_y         = alloc_array(capacity, sizeof(float), &ok);
+    scene->pos_z         = alloc_array(capacity, sizeof(float), &ok);
+    scene->rot_x         = alloc_array(capacity, sizeof(float), &ok);
+    scene->rot_y         = alloc_array(capacity, sizeof(float), &ok);
+    scene->rot_z         = alloc_array(capacity, sizeof(float), &ok);
+    scene->rot_w         = alloc_array(capacity, sizeof(float), &ok);
+    scene->scale_x       = alloc_array(capacity, sizeof(float), &ok);
+    scene->scale_y       = alloc_array(capacity, sizeof(float), &ok);
+    scene->scale_z       = alloc_array(capacity, sizeof(float), &ok);
+    scene->world         = alloc_array(capacity, sizeof(HMM_Mat4), &ok);
+    scene->local_x       = alloc_array(capacity, sizeof(float), &ok);
+    scene->local_y       = alloc_array(capacity, sizeof(float), &ok);
+    scene->local_z       = alloc_array(capacity, sizeof(float), &ok);
+    scene->local_radius  = alloc_array(capacity, sizeof(float), &ok);
+    scene->sphere_x      = alloc_array(capacity, sizeof(float), &ok);
+    scene->sphere_y      = alloc_array(capacity, sizeof(float), &ok);
+    scene->sphere_z      = alloc_array(capacity, sizeof(float), &ok);
+    scene->sphere_radius = alloc_array(capacity, sizeof(float), &ok);
+    scene->mesh          = alloc_array(capacity, sizeof(uint32_t), &ok);
+    scene->material      = alloc_array(capacity, sizeof(uint32_t), &ok);
+    scene->lod           = alloc_array(capacity, sizeof(uint8_t), &ok);
+    if (!ok) scene_free(scene);
+    return ok;
+}
+
+void scene_free(Scene *scene) {
+    free(scene->pos_x);
+    free(scene->pos_y);
+    free(scene->pos_z);
+    free(scene->rot_x);
+    free(scene->rot_y);
+    free(scene->rot_z);
+    free(scene->rot_w);
+    free(scene->scale_x);
+    free(scene->scale_y);
+    free(scene->scale_z);
+    free(scene->world);
+    free(scene->local_x);
+    free(scene->local_y);
+    free(scene->local_z);
+    free(scene->local_radius);
+    free(scene->sphere_x);
+    free(scene->sphere_y);
+    free(scene->sphere_z);
+    free(scene->sphere_radius);
+    free(scene->mesh);
+    free(scene->material);
+    free(scene->lod);
+    pool_free(&scene->entities);
+    *scene = (Scene){0};
+}
+
+uint32_t scene_add(Scene *scene, HMM_Vec3 position, HMM_Quat rotation, HMM_Vec3 scale,
+                   uint32_t mesh, uint32_t material) {
+    if (pool_alloc(&scene->entities) == POOL_INVALID) return SCENE_INVALID;
+
+    uint32_t i = scene->count++;
+    scene->pos_x[i]        = position.X;
+    scene->pos_y[i]        = position.Y;
+    scene->pos_z[i]        = position.Z;
+    scene->rot_x[i]        = rotation.X;
+    scene->rot_y[i]        = rotation.Y;
+    scene->rot_z[i]        = rotation.Z;
+    scene->rot_w[i]        = rotation.W;
+    scene->scale_x[i]      = scale.X;
+    scene->scale_y[i]      = scale.Y;
+    scene->scale_z[i]      = scale.Z;
+    scene->world[i]        = HMM_M4D(1.0f);
+    scene->local_x[i]      = 0.0f;
+    scene->local_y[i]      = 0.0f;
+    scene->local_z[i]      = 0.0f;
+    scene->local_radius[i] = 0.0f;
+    scene->mesh[i]         = mesh;
+    scene->material[i]     = material;
+    scene->lod[i]          = 0;
+    return i;
+}
+
+void scene_set_bounds(Scene *scene, uint32_t index, HMM_Vec3 center, float radius) {
+    if (index >= scene->count) return;
+    scene->local_x[index]      = center.X;
+    scene->local_y[index]      = center.Y;
+    scene->local_z[index]      = center.Z;
+    scene->local_radius[index] = radius;
+}
+
+void scene_remove(Scene *scene, uint32_t index) {
+    if (index >= scene->count) return;
+
+    // The pool swap-removes the same way, keeping handles in step
+    pool_release(&scene->entities, scene->entities.handles[index]);
+    uint32_t last = --scene->count;
+    scene->pos_x[index]         = scene->pos_x[last];
+    scene->pos_y[index]         = scene->pos_y[last];
+    scene->pos_z[index]         = scene->pos_z[last];
+    scene->rot_x[index]         = scene->rot_x[last];
+    scene->rot_y[index]         = scene->rot_y[last];
+    scene->rot_z[index]         = scene->rot_z[last];
+    scene->rot_w[index]         = scene->rot_w[last];
+    scene->scale_x[index]       = scene->scale_x[last];
+    scene->scale_y[index]       = scene->scale_y[last];
+    scene->scale_z[index]       = scene->scale_z[last];
+    scene->world[index]         = scene->world[last];
+    scene->local_x[index]       = scene->local_x[last];
+    scene->local_y[index]       = scene->local_y[last];
+    scene->local_z[index]       = scene->local_z[last];
+    scene->local_radius[index]  = scene->local_radius[last];
+    scene->sphere_x[index]      = scene->sphere_x[last];
+    scene->sphere_y[index]      = scene->sphere_y[last];
+    scene->sphere_z[index]      = scene->sphere_z[last];
+    scene->sphere_radius[index] = scene->sphere_radius[last];
+    scene->mesh[index]          = scene->mesh[last];
+    scene->material[index]      = scene->material[last];
+    scene->lod[index]           = scene->lod[last];
+}
+
+uint32_t scene_handle(const Scene *scene, uint32_t index) {
+    return index < scene->count ? scene->entities.handles[index] : POOL_INVALID;
+}
+
+uint32_t scene_lookup(const Scene *scene, uint32_t handle) {
+    uint32_t index = pool_index(&scene->entities, handle);
+    return index != UINT32_MAX ? index : SCENE_INVALID;
+}
+
+uint32_t scene_update_transforms(Scene *scene, uint32_t *moved) {
+    return scene_update_transforms_range(scene, 0, scene->count, moved);
+}
+
+uint32_t scene_update_transforms_range(Scene *scene, uint32_t begin, uint32_t end, uint32_t *moved) {
+    if (end > scene->count) end = scene->count;
+    if (begin >= end) return 0;
+
+    TransformSoA in = {
+        .pos   = { scene->pos_x + begin, scene->pos_y + begin, scene->pos_z + begin },
+        .rot   = { scene->rot_x + begin, scene->rot_y + begin, scene->rot_z + begin, scene->rot_w + begin },
+        .scale = { scene->scale_x + begin, scene->scale_y + begin, scene->scale_z + begin },
+    };
+    transform_compose(&in, scene->world + begin, end - begin);
+
+    // World sphere: transformed centre, radius scaled by the largest axis
+    uint32_t moved_count = 0;
+    for (uint32_t i = begin; i < end; i++) {
+        const float (*m)[4] = (const float (*)[4])scene->world[i].Elements;
+        float lx = scene->local_x[i], ly = scene->local_y[i], lz = scene->local_z[i];
+        float x  = m[0][0] * lx + m[1][0] * ly + m[2][0] * lz + m[3][0];
+        float y  = m[0][1] * lx + m[1][1] * ly + m[2][1] * lz + m[3][1];
+        float z  = m[0][2] * lx + m[1][2] * ly + m[2][2] * lz + m[3][2];
+
+        float s = fabsf(scene->scale_x[i]);
+        if (fabsf(scene->scale_y[i]) > s) s = fabsf(scene->scale_y[i]);
+        if (fabsf(scene->scale_z[i]) > s) s = fabsf(scene->scale_z[i]);
+        float r = scene->local_radius[i] * s;
+
+        if (x != scene->sphere_x[i] || y != scene->sphere_y[i] || z != scene->sphere_z[i] ||
+            r != scene->sphere_radius[i]) {
+            scene->sphere_x[i]      = x;
+            scene->sphere_y[i]      = y;
+            scene->sphere_z[i]      = z;
+            scene->sphere_radius[i] = r;
+            if (moved) moved[moved_count] = i;
+            moved_count++;
+        }
+    }
+    return moved_count;
+}
@@ -0,0 +1,140 @@
+#include "stats.h"
+#include "sokol_gfx.h"
+#include "sokol_time.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+static const char *stat_names[STAT_COUNT] = {
+    [STAT_CPU_MS]        = "cpu_ms",
+    [STAT_GPU_MS]        = "gpu_ms",
+    [STAT_PASSES]        = "passes",
+    [STAT_PIPELINES]     = "pipelines",
+    [STAT_BINDINGS]      = "bindings",
+    [STAT_UNIFORMS]      = "uniforms",
+    [STAT_DRAWS]         = "draws",
+    [STAT_UNIFORM_BYTES] = "uniform_bytes",
+    [STAT_UPLOAD_BYTES]  = "upload_bytes",
+    [STAT_OCCLUDED]      = "occluded",
+};
+
+static struct {
+    double  *samples;   // window values per stat, ring indexed by frame
+    double  *scratch;   // window values, reordered by stats_summary()
+    uint32_t window;
+    uint64_t frames;
+} stats;
+
+bool stats_setup(uint32_t window) {
+    stats.window  = window > 0 ? window : STATS_DEFAULT_WINDOW;
+    stats.frames  = 0;
+    stats.samples = calloc((size_t)STAT_COUNT * stats.window, sizeof(double));
+    stats.scratch = malloc(stats.window * sizeof(double));
+    if (!stats.samples || !stats.scratch) {
+        stats_shutdown();
+        return false;
+    }
+    sg_enable_stats();
+    return true;
+}
+
+void stats_shutdown(void) {
+    free(stats.samples);
+    free(stats.scratch);
+    stats.samples = NULL;
+    stats.scratch = NULL;
+}
+
+void stats_frame(const FrameTiming *timing) {
+    if (!stats.samples) return;
+
+    // sg_commit() moved the committed frame's counts into prev_frame
+    sg_frame_stats f = sg_query_stats().prev_frame;
+    double v[STAT_COUNT] = {
+        [STAT_CPU_MS]        = stm_ms(timing->total),
+        [STAT_GPU_MS]        = (double)timing->gpu[FRAME_GPU_MAIN] * 1e-6,
+        [STAT_PASSES]        = f.num_passes,
+        [STAT_PIPELINES]     = f.num_apply_pipeline,
+        [STAT_BINDINGS]      = f.num_apply_bindings,
+        [STAT_UNIFORMS]      = f.num_apply_uniforms,
+        [STAT_DRAWS]         = (double)f.num_draw + f.num_draw_ex,
+        [STAT_UNIFORM_BYTES] = f.size_apply_uniforms,
+        [STAT_UPLOAD_BYTES]  = (double)f.size_update_buffer + f.size_append_buffer + f.size_update_image,
+        [STAT_OCCLUDED]      = timing->counters[FRAME_COUNTER_OCCLUDED],
+    };
+    uint32_t slot = (uint32_t)(stats.frames % stats.window);
+    for (int s = 0; s < STAT_COUNT; s++) stats.samples[(size_t)s * stats.window + slot] = v[s];
+    stats.frames++;
+}
+
+uint64_t stats_frame_count(void) {
+    return stats.frames;
+}
+
+bool stats_window_done(void) {
+    return stats.frames > 0 && stats.frames % stats.window == 0;
+}
+
+// Hoare quickselect: reorders v so v[k] is the value a full sort would put
+// there
+static double select_nth(double *v, uint32_t n, uint32_t k) {
+    uint32_t lo = 0, hi = n - 1;
+    while (lo < hi) {
+        double   pivot = v[lo + (hi - lo) / 2];
+        uint32_t i = lo, j = hi;
+        while (i <= j) {
+            while (v[i] < pivot) i++;
+            while (v[j] > pivot) j--;
+            if (i <= j) {
+                double t = v[i];
+                v[i++] = v[j];
+                v[j]   = t;
+                if (j == 0) break;
+                j--;
+            }
+        }
+        if (k <= j) {
+            hi = j;
+        } else if (k >= i) {
+            lo = i;
+        } else {
+            break;
+        }
+    }
+    return v[k];
+}
+
+StatSummary stats_summary(Stat stat) {
+    uint32_t n = stats.frames < stats.window ? (uint32_t)stats.frames : stats.window;
+    if (!stats.samples || n == 0) return (StatSummary){0};
+
+    const double *src = stats.samples + (size_t)stat * stats.window;
+    StatSummary   sum = { .min = src[0], .max = src[0] };
+    double        total = 0.0;
+    for (uint32_t i = 0; i < n; i++) {
+        stats.scratch[i] = src[i];
+        total += src[i];
+        if (src[i] < sum.min) sum.min = src[i];
+        if (src[i] > sum.max) sum.max = src[i];
+    }
+    sum.avg = total / n;
+    sum.p99 = select_nth(stats.scratch, n, (n * 99) / 100);
+    return sum;
+}
+
+const char *stats_name(Stat stat) {
+    return stat_names[stat];
+}
+
+bool stats_write_csv(const char *path) {
+    FILE *f = fopen(path, "w");
+    if (!f) return false;
+
+    uint64_t n = stats.frames < stats.window ? stats.frames : stats.window;
+    fprintf(f, "stat,min,avg,p99,max,frames\n");
+    for (int s = 0; s < STAT_COUNT; s++) {
+        StatSummary sum = stats_summary((Stat)s);
+        fprintf(f, "%s,%.6g,%.6g,%.6g,%.6g,%llu\n", stat_names[s], sum.min, sum.avg, sum.p99, sum.max,
+                (unsigned long long)n);
+    }
+    return fclose(f) == 0;
+}
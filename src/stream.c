@@ -0,0 +1,87 @@
+#include "stream.h"
+#include <stdlib.h>
+#include <string.h>
+
+// sg_append_buffer() keeps offsets 4-byte aligned; staging matches it so
+// staging offsets are buffer offsets
+#define STREAM_ALIGN 4
+
+bool stream_init(Stream *stream, size_t capacity, bool index, const char *label) {
+    capacity = (capacity + STREAM_ALIGN - 1) & ~(size_t)(STREAM_ALIGN - 1);
+    *stream  = (Stream){ .index = index, .label = label, .capacity = capacity };
+    stream->staging = malloc(capacity);
+    if (!stream->staging) return false;
+
+    for (int i = 0; i < STREAM_FRAMES; i++) {
+        stream->buffers[i] = sg_make_buffer(&(sg_buffer_desc){
+            .size  = capacity,
+            .usage = {
+                .vertex_buffer = !index,
+                .index_buffer  = index,
+                .stream_update = true,
+            },
+            .label = label,
+        });
+    }
+    return true;
+}
+
+void stream_destroy(Stream *stream) {
+    for (int i = 0; i < STREAM_FRAMES; i++) sg_destroy_buffer(stream->buffers[i]);
+    free(stream->staging);
+    *stream = (Stream){0};
+}
+
+bool stream_reserve(Stream *stream, size_t capacity) {
+    if (capacity <= stream->capacity) return true;
+    Stream grown;
+    if (!stream_init(&grown, capacity, stream->index, stream->label)) return false;
+    stream_destroy(stream);
+    *stream = grown;
+    return true;
+}
+
+void *stream_alloc(Stream *stream, size_t size, uint32_t *offset) {
+    size_t aligned = (size + STREAM_ALIGN - 1) & ~(size_t)(STREAM_ALIGN - 1);
+    if (aligned > stream->capacity - stream->used) {
+        stream->dropped += size;
+        return NULL;
+    }
+    uint8_t *ptr = stream->staging + stream->used;
+    *offset       = (uint32_t)stream->used;
+    stream->used += aligned;
+    return ptr;
+}
+
+uint32_t stream_append(Stream *stream, const void *data, size_t size) {
+    uint32_t offset;
+    void    *dst = stream_alloc(stream, size, &offset);
+    if (!dst) return STREAM_FULL;
+    memcpy(dst, data, size);
+    return offset;
+}
+
+void stream_rewind(Stream *stream, size_t used) {
+    used = (used + STREAM_ALIGN - 1) & ~(size_t)(STREAM_ALIGN - 1);
+    if (used < stream->flushed) used = stream->flushed;
+    if (used < stream->used) stream->used = used;
+}
+
+void stream_flush(Stream *stream) {
+    if (stream->used == stream->flushed) return;
+    sg_append_buffer(stream_buffer(stream), &(sg_range){
+        stream->staging + stream->flushed, stream->used - stream->flushed
+    });
+    stream->flushed = stream->used;
+}
+
+sg_buffer stream_buffer(const Stream *stream) {
+    return stream->buffers[stream->current];
+}
+
+void stream_next_frame(Stream *stream) {
+    stream->current = (stream->current + 1) % STREAM_FRAMES;
+    stream->used    = 0;
+    stream->flushed = 0;
+    stream->dropped = 0;
+}
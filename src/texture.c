@@ -0,0 +1,268 @@
+#include "texture.h"
+#include "texture_cache.h"
+#include "profile.h"
+#include "sokol_fetch.h"
+#include "sokol_log.h"
+#include "sokol_time.h"
+#include "stb_image.h"
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define TEXTURE_MAX_PATH 256
+
+// Lifetime of a pending load. The fetch runs on sokol_fetch's IO threads, the
+// PNG decode on a thread of its own; only the upload happens on the main thread.
+enum {
+    PENDING_FREE,
+    PENDING_FETCHING,
+    PENDING_DECODING,
+    PENDING_DECODED,
+    PENDING_FAILED,
+};
+
+typedef struct {
+    Texture       *tex;
+    atomic_int     stage;
+    pthread_t      thread;
+    bool           has_thread;
+
+    // Fetched file, owned by the decode thread once it is started
+    void          *file;
+    size_t         file_size;
+
+    // Decode result, consumed by texture_update()
+    unsigned char *pixels;
+    int            width;
+    int            height;
+
+    // Decode threads are short-lived, so rather than give each a profiler
+    // ring the main thread records their span when it picks the result up
+    uint64_t       decode_start;
+    uint64_t       decode_end;
+} PendingTexture;
+
+static struct {
+    PendingTexture pending[TEXTURE_MAX_PENDING];
+    sg_image       placeholder_img;
+    sg_view        placeholder_view;
+} textures;
+
+static void *decode_thread(void *arg) {
+    PendingTexture *p = arg;
+    int channels;
+    p->decode_start = stm_now();
+    p->pixels = stbi_load_from_memory(p->file, (int)p->file_size,
+                                      &p->width, &p->height, &channels, 4);
+    p->decode_end = stm_now();
+    free(p->file);
+    p->file = NULL;
+    atomic_store(&p->stage, p->pixels ? PENDING_DECODED : PENDING_FAILED);
+    return NULL;
+}
+
+static void fetch_callback(const sfetch_response_t *response) {
+    PendingTexture *p = &textures.pending[*(int *)response->user_data];
+
+    if (response->fetched) {
+        p->file      = (void *)response->buffer.ptr;
+        p->file_size = response->data.size;
+        atomic_store(&p->stage, PENDING_DECODING);
+        if (pthread_create(&p->thread, NULL, decode_thread, p) == 0) {
+            p->has_thread = true;
+        } else {
+            // No thread available: decode here rather than drop the texture
+            decode_thread(p);
+        }
+    }
+    if (response->failed) {
+        free((void *)response->buffer.ptr);
+        atomic_store(&p->stage, PENDING_FAILED);
+    }
+}
+
+void texture_setup(void) {
+    sfetch_setup(&(sfetch_desc_t){
+        .max_requests = TEXTURE_MAX_PENDING,
+        .num_channels = 1,
+        .num_lanes    = 4,
+        .logger.func  = slog_func,
+    });
+    stbi_set_flip_vertically_on_load(true);
+
+    // Mid grey, shown until a texture has finished loading
+    static const uint32_t grey = 0xFF808080;
+    textures.placeholder_img = sg_make_image(&(sg_image_desc){
+        .width  = 1,
+        .height = 1,
+        .data.mip_levels[0] = SG_RANGE(grey),
+        .label  = "placeholder-texture",
+    });
+    textures.placeholder_view = sg_make_view(&(sg_view_desc){
+        .texture.image = textures.placeholder_img,
+        .label         = "placeholder-texture-view",
+    });
+}
+
+void texture_shutdown(void) {
+    sfetch_shutdown();
+    for (int i = 0; i < TEXTURE_MAX_PENDING; i++) {
+        PendingTexture *p = &textures.pending[i];
+        if (p->has_thread) pthread_join(p->thread, NULL);
+        stbi_image_free(p->pixels);
+        *p = (PendingTexture){0};
+    }
+}
+
+// Check a mapped cache file and point desc's mip levels into it
+static bool parse_cache(const uint8_t *map, size_t size, sg_image_desc *desc) {
+    const TexCacheHeader *h = (const TexCacheHeader *)map;
+    if (size < sizeof(*h)
+        || h->magic != TEXCACHE_MAGIC
+        || h->version != TEXCACHE_VERSION
+        || h->num_mips == 0 || h->num_mips > TEXCACHE_MAX_MIPS
+        || h->width == 0 || h->height == 0
+        || h->width > TEXCACHE_MAX_SIZE || h->height > TEXCACHE_MAX_SIZE) {
+        return false;
+    }
+
+    *desc = (sg_image_desc){
+        .width       = (int)h->width,
+        .height      = (int)h->height,
+        .num_mipmaps = (int)h->num_mips,
+        .label       = "texture",
+    };
+    uint32_t w = h->width, hh = h->height;
+    for (uint32_t i = 0; i < h->num_mips; i++) {
+        const TexCacheMip *mip = &h->mips[i];
+        if (mip->size != (uint64_t)w * hh * 4 || (uint64_t)mip->offset + mip->size > size) return false;
+        desc->data.mip_levels[i] = (sg_range){ .ptr = map + mip->offset, .size = mip->size };
+        w  = w  > 1 ? w  / 2 : 1;
+        hh = hh > 1 ? hh / 2 : 1;
+    }
+    return true;
+}
+
+// Load the cooked cache next to the source image (foo.png -> foo.tex). The
+// mapped mip chain goes straight to sokol_gfx: no decode, no staging copy.
+static bool load_cached(Texture *tex, const char *path) {
+    char cache_path[TEXTURE_MAX_PATH];
+    const char *ext = strrchr(path, '.');
+    size_t stem = ext ? (size_t)(ext - path) : strlen(path);
+    if (stem + sizeof(".tex") > sizeof(cache_path)) return false;
+    memcpy(cache_path, path, stem);
+    memcpy(cache_path + stem, ".tex", sizeof(".tex"));
+
+    int fd = open(cache_path, O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        close(fd);
+        return false;
+    }
+    size_t size = (size_t)st.st_size;
+    void *map = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) return false;
+
+    sg_image_desc desc;
+    bool valid = parse_cache(map, size, &desc);
+    if (valid) {
+        tex->img  = sg_make_image(&desc);
+        tex->view = sg_make_view(&(sg_view_desc){
+            .texture.image = tex->img,
+            .label         = "texture-view",
+        });
+        tex->state = TEXTURE_READY;
+    }
+    munmap(map, size);
+    return valid;
+}
+
+bool texture_load(Texture *tex, const char *path) {
+    if (load_cached(tex, path)) return true;
+
+    int slot = -1;
+    for (int i = 0; i < TEXTURE_MAX_PENDING; i++) {
+        if (atomic_load(&textures.pending[i].stage) == PENDING_FREE) {
+            slot = i;
+            break;
+        }
+    }
+    if (slot < 0) return false;
+
+    void *buffer = malloc(TEXTURE_MAX_FILE_SIZE);
+    if (!buffer) return false;
+
+    PendingTexture *p = &textures.pending[slot];
+    *p = (PendingTexture){ .tex = tex };
+    atomic_store(&p->stage, PENDING_FETCHING);
+
+    tex->img   = sg_alloc_image();
+    tex->view  = sg_alloc_view();
+    tex->state = TEXTURE_LOADING;
+
+    sfetch_send(&(sfetch_request_t){
+        .path      = path,
+        .callback  = fetch_callback,
+        .buffer    = { .ptr = buffer, .size = TEXTURE_MAX_FILE_SIZE },
+        .user_data = SFETCH_RANGE(slot),
+    });
+    return true;
+}
+
+void texture_update(void) {
+    sfetch_dowork();
+
+    for (int i = 0; i < TEXTURE_MAX_PENDING; i++) {
+        PendingTexture *p = &textures.pending[i];
+        int stage = atomic_load(&p->stage);
+        if (stage != PENDING_DECODED && stage != PENDING_FAILED) continue;
+
+        if (p->has_thread) pthread_join(p->thread, NULL);
+        if (p->decode_end) profile_record("texture decode", p->decode_start, p->decode_end);
+
+        Texture *tex = p->tex;
+        profile_begin("texture upload");
+        if (stage == PENDING_DECODED) {
+            sg_init_image(tex->img, &(sg_image_desc){
+                .width  = p->width,
+                .height = p->height,
+                .data.mip_levels[0] = {
+                    .ptr  = p->pixels,
+                    .size = (size_t)p->width * (size_t)p->height * 4,
+                },
+                .label  = "texture",
+            });
+            sg_init_view(tex->view, &(sg_view_desc){
+                .texture.image = tex->img,
+                .label         = "texture-view",
+            });
+            stbi_image_free(p->pixels);
+            tex->state = TEXTURE_READY;
+        } else {
+            sg_fail_image(tex->img);
+            sg_fail_view(tex->view);
+            tex->state = TEXTURE_FAILED;
+        }
+        profile_end();
+
+        *p = (PendingTexture){0};
+    }
+}
+
+bool texture_pending(void) {
+    for (int i = 0; i < TEXTURE_MAX_PENDING; i++) {
+        if (atomic_load(&textures.pending[i].stage) != PENDING_FREE) return true;
+    }
+    return false;
+}
+
+sg_view texture_view(const Texture *tex) {
+    return tex->state == TEXTURE_READY ? tex->view : textures.placeholder_view;
+}
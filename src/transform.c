@@ -0,0 +1,310 @@
+#include "transform.h"
+#include <pthread.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+    #define TRANSFORM_X86 1
+    #include <immintrin.h>
+#endif
+
+typedef void (*ComposeFunc)(const TransformSoA *in, HMM_Mat4 *world, uint32_t begin, uint32_t end);
+typedef void (*MulFunc)(HMM_Mat4 m, const HMM_Mat4 *in, HMM_Mat4 *out, uint32_t begin, uint32_t end);
+
+static struct {
+    pthread_once_t   once;
+    TransformBackend backend;
+    ComposeFunc      compose;
+    MulFunc          mul;
+    uint32_t         width;   // matrices per SIMD iteration; tails go scalar
+} impl = { .once = PTHREAD_ONCE_INIT };
+
+// --- Scalar ------------------------------------------------------------------
+
+static void compose_scalar(const TransformSoA *in, HMM_Mat4 *world, uint32_t begin, uint32_t end) {
+    for (uint32_t i = begin; i < end; i++) {
+        float x  = in->rot[0][i],   y  = in->rot[1][i],   z  = in->rot[2][i], w = in->rot[3][i];
+        float sx = in->scale[0][i], sy = in->scale[1][i], sz = in->scale[2][i];
+
+        float xx = x * x, yy = y * y, zz = z * z;
+        float xy = x * y, xz = x * z, yz = y * z;
+        float wx = w * x, wy = w * y, wz = w * z;
+
+        // Column-major: Elements[column][row]
+        float (*m)[4] = world[i].Elements;
+        m[0][0] = (1.0f - 2.0f * (yy + zz)) * sx;
+        m[0][1] = (2.0f * (xy + wz)) * sx;
+        m[0][2] = (2.0f * (xz - wy)) * sx;
+        m[0][3] = 0.0f;
+
+        m[1][0] = (2.0f * (xy - wz)) * sy;
+        m[1][1] = (1.0f - 2.0f * (xx + zz)) * sy;
+        m[1][2] = (2.0f * (yz + wx)) * sy;
+        m[1][3] = 0.0f;
+
+        m[2][0] = (2.0f * (xz + wy)) * sz;
+        m[2][1] = (2.0f * (yz - wx)) * sz;
+        m[2][2] = (1.0f - 2.0f * (xx + yy)) * sz;
+        m[2][3] = 0.0f;
+
+        m[3][0] = in->pos[0][i];
+        m[3][1] = in->pos[1][i];
+        m[3][2] = in->pos[2][i];
+        m[3][3] = 1.0f;
+    }
+}
+
+static void mul_scalar(HMM_Mat4 m, const HMM_Mat4 *in, HMM_Mat4 *out, uint32_t begin, uint32_t end) {
+    for (uint32_t i = begin; i < end; i++) {
+        for (int c = 0; c < 4; c++) {
+            const float *v = in[i].Elements[c];
+            for (int r = 0; r < 4; r++) {
+                out[i].Elements[c][r] = m.Elements[0][r] * v[0] + m.Elements[1][r] * v[1]
+                                      + m.Elements[2][r] * v[2] + m.Elements[3][r] * v[3];
+            }
+        }
+    }
+}
+
+#if TRANSFORM_X86
+
+// --- SSE: 4 transforms per iteration -----------------------------------------
+//
+// Lane k of every vector belongs to transform i+k. The 16 matrix elements are
+// computed as 16 vectors, then each column is transposed out to its matrix.
+
+static void compose_sse(const TransformSoA *in, HMM_Mat4 *world, uint32_t begin, uint32_t end) {
+    const __m128 one  = _mm_set1_ps(1.0f);
+    const __m128 two  = _mm_set1_ps(2.0f);
+    const __m128 zero = _mm_setzero_ps();
+
+    for (uint32_t i = begin; i < end; i += 4) {
+        __m128 x  = _mm_loadu_ps(in->rot[0] + i),   y  = _mm_loadu_ps(in->rot[1] + i);
+        __m128 z  = _mm_loadu_ps(in->rot[2] + i),   w  = _mm_loadu_ps(in->rot[3] + i);
+        __m128 sx = _mm_loadu_ps(in->scale[0] + i), sy = _mm_loadu_ps(in->scale[1] + i);
+        __m128 sz = _mm_loadu_ps(in->scale[2] + i);
+
+        __m128 xx = _mm_mul_ps(x, x), yy = _mm_mul_ps(y, y), zz = _mm_mul_ps(z, z);
+        __m128 xy = _mm_mul_ps(x, y), xz = _mm_mul_ps(x, z), yz = _mm_mul_ps(y, z);
+        __m128 wx = _mm_mul_ps(w, x), wy = _mm_mul_ps(w, y), wz = _mm_mul_ps(w, z);
+
+        __m128 col[4][4] = {
+            {
+                _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(yy, zz))), sx),
+                _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xy, wz)), sx),
+                _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xz, wy)), sx),
+                zero,
+            },
+            {
+                _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xy, wz)), sy),
+                _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, zz))), sy),
+                _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(yz, wx)), sy),
+                zero,
+            },
+            {
+                _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xz, wy)), sz),
+                _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(yz, wx)), sz),
+                _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, yy))), sz),
+                zero,
+            },
+            {
+                _mm_loadu_ps(in->pos[0] + i),
+                _mm_loadu_ps(in->pos[1] + i),
+                _mm_loadu_ps(in->pos[2] + i),
+                one,
+            },
+        };
+
+        for (int c = 0; c < 4; c++) {
+            _MM_TRANSPOSE4_PS(col[c][0], col[c][1], col[c][2], col[c][3]);
+            for (int k = 0; k < 4; k++) _mm_storeu_ps(world[i + k].Elements[c], col[c][k]);
+        }
+    }
+}
+
+static void mul_sse(HMM_Mat4 m, const HMM_Mat4 *in, HMM_Mat4 *out, uint32_t begin, uint32_t end) {
+    const __m128 m0 = _mm_loadu_ps(m.Elements[0]), m1 = _mm_loadu_ps(m.Elements[1]);
+    const __m128 m2 = _mm_loadu_ps(m.Elements[2]), m3 = _mm_loadu_ps(m.Elements[3]);
+
+    for (uint32_t i = begin; i < end; i++) {
+        for (int c = 0; c < 4; c++) {
+            __m128 v = _mm_loadu_ps(in[i].Elements[c]);
+            __m128 r = _mm_mul_ps(m0, _mm_shuffle_ps(v, v, 0x00));
+            r = _mm_add_ps(r, _mm_mul_ps(m1, _mm_shuffle_ps(v, v, 0x55)));
+            r = _mm_add_ps(r, _mm_mul_ps(m2, _mm_shuffle_ps(v, v, 0xAA)));
+            r = _mm_add_ps(r, _mm_mul_ps(m3, _mm_shuffle_ps(v, v, 0xFF)));
+            _mm_storeu_ps(out[i].Elements[c], r);
+        }
+    }
+}
+
+// --- AVX2: 8 transforms per compose iteration, 2 per multiply ---------------
+
+#define AVX2 __attribute__((target("avx2,fma")))
+
+// Transpose 4 vectors of 8 lanes: result k holds lane k in its low half and
+// lane k+4 in its high half
+AVX2 static inline void transpose4_avx(__m256 r[4]) {
+    __m256 t0 = _mm256_unpacklo_ps(r[0], r[1]);
+    __m256 t1 = _mm256_unpackhi_ps(r[0], r[1]);
+    __m256 t2 = _mm256_unpacklo_ps(r[2], r[3]);
+    __m256 t3 = _mm256_unpackhi_ps(r[2], r[3]);
+    r[0] = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+    r[1] = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+    r[2] = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+    r[3] = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+}
+
+AVX2 static void compose_avx2(const TransformSoA *in, HMM_Mat4 *world, uint32_t begin, uint32_t end) {
+    const __m256 one  = _mm256_set1_ps(1.0f);
+    const __m256 two  = _mm256_set1_ps(2.0f);
+    const __m256 zero = _mm256_setzero_ps();
+
+    for (uint32_t i = begin; i < end; i += 8) {
+        __m256 x  = _mm256_loadu_ps(in->rot[0] + i),   y  = _mm256_loadu_ps(in->rot[1] + i);
+        __m256 z  = _mm256_loadu_ps(in->rot[2] + i),   w  = _mm256_loadu_ps(in->rot[3] + i);
+        __m256 sx = _mm256_loadu_ps(in->scale[0] + i), sy = _mm256_loadu_ps(in->scale[1] + i);
+        __m256 sz = _mm256_loadu_ps(in->scale[2] + i);
+
+        __m256 xx = _mm256_mul_ps(x, x), yy = _mm256_mul_ps(y, y), zz = _mm256_mul_ps(z, z);
+        __m256 xy = _mm256_mul_ps(x, y), xz = _mm256_mul_ps(x, z), yz = _mm256_mul_ps(y, z);
+        __m256 wx = _mm256_mul_ps(w, x), wy = _mm256_mul_ps(w, y), wz = _mm256_mul_ps(w, z);
+
+        __m256 col[4][4] = {
+            {
+                _mm256_mul_ps(_mm256_fnmadd_ps(two, _mm256_add_ps(yy, zz), one), sx),
+                _mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(xy, wz)), sx),
+                _mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(xz, wy)), sx),
+                zero,
+            },
+            {
+                _mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(xy, wz)), sy),
+                _mm256_mul_ps(_mm256_fnmadd_ps(two, _mm256_add_ps(xx, zz), one), sy),
+                _mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(yz, wx)), sy),
+                zero,
+            },
+            {
+                _mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(xz, wy)), sz),
+                _mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(yz, wx)), sz),
+                _mm256_mul_ps(_mm256_fnmadd_ps(two, _mm256_add_ps(xx, yy), one), sz),
+                zero,
+            },
+            {
+                _mm256_loadu_ps(in->pos[0] + i),
+                _mm256_loadu_ps(in->pos[1] + i),
+                _mm256_loadu_ps(in->pos[2] + i),
+                one,
+            },
+        };
+
+        for (int c = 0; c < 4; c++) {
+            transpose4_avx(col[c]);
+            for (int k = 0; k < 4; k++) {
+                _mm_storeu_ps(world[i + k].Elements[c],     _mm256_castps256_ps128(col[c][k]));
+                _mm_storeu_ps(world[i + k + 4].Elements[c], _mm256_extractf128_ps(col[c][k], 1));
+            }
+        }
+    }
+}
+
+AVX2 static void mul_avx2(HMM_Mat4 m, const HMM_Mat4 *in, HMM_Mat4 *out, uint32_t begin, uint32_t end) {
+    // Each column of m in both halves; a pair of matrices per iteration
+    const __m256 m0 = _mm256_broadcast_ps((const __m128 *)m.Elements[0]);
+    const __m256 m1 = _mm256_broadcast_ps((const __m128 *)m.Elements[1]);
+    const __m256 m2 = _mm256_broadcast_ps((const __m128 *)m.Elements[2]);
+    const __m256 m3 = _mm256_broadcast_ps((const __m128 *)m.Elements[3]);
+
+    for (uint32_t i = begin; i < end; i += 2) {
+        for (int c = 0; c < 4; c++) {
+            __m256 v = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(in[i].Elements[c])),
+                                            _mm_loadu_ps(in[i + 1].Elements[c]), 1);
+            __m256 r = _mm256_mul_ps(m0, _mm256_shuffle_ps(v, v, 0x00));
+            r = _mm256_fmadd_ps(m1, _mm256_shuffle_ps(v, v, 0x55), r);
+            r = _mm256_fmadd_ps(m2, _mm256_shuffle_ps(v, v, 0xAA), r);
+            r = _mm256_fmadd_ps(m3, _mm256_shuffle_ps(v, v, 0xFF), r);
+            _mm_storeu_ps(out[i].Elements[c],     _mm256_castps256_ps128(r));
+            _mm_storeu_ps(out[i + 1].Elements[c], _mm256_extractf128_ps(r, 1));
+        }
+    }
+}
+
+#endif // TRANSFORM_X86
+
+// --- Dispatch ----------------------------------------------------------------
+
+static bool supported(TransformBackend backend) {
+    switch (backend) {
+        case TRANSFORM_SCALAR: return true;
+#if TRANSFORM_X86
+        case TRANSFORM_SSE:    return __builtin_cpu_supports("sse2");
+        case TRANSFORM_AVX2:   return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#endif
+        default:               return false;
+    }
+}
+
+static void select_backend(TransformBackend backend) {
+    impl.backend = backend;
+    switch (backend) {
+#if TRANSFORM_X86
+        case TRANSFORM_AVX2:
+            impl.compose = compose_avx2;
+            impl.mul     = mul_avx2;
+            impl.width   = 8;
+            break;
+        case TRANSFORM_SSE:
+            impl.compose = compose_sse;
+            impl.mul     = mul_sse;
+            impl.width   = 4;
+            break;
+#endif
+        default:
+            impl.compose = compose_scalar;
+            impl.mul     = mul_scalar;
+            impl.width   = 1;
+            break;
+    }
+}
+
+static void select_best(void) {
+    TransformBackend best = TRANSFORM_SCALAR;
+    for (int b = TRANSFORM_SCALAR; b < TRANSFORM_BACKEND_COUNT; b++) {
+        if (supported((TransformBackend)b)) best = (TransformBackend)b;
+    }
+    select_backend(best);
+}
+
+void transform_compose(const TransformSoA *in, HMM_Mat4 *world, uint32_t count) {
+    pthread_once(&impl.once, select_best);
+    uint32_t body = count - count % impl.width;
+    impl.compose(in, world, 0, body);
+    compose_scalar(in, world, body, count);
+}
+
+void transform_mul(HMM_Mat4 m, const HMM_Mat4 *in, HMM_Mat4 *out, uint32_t count) {
+    pthread_once(&impl.once, select_best);
+    // The multiply kernels step at most 2 matrices at a time
+    uint32_t width = impl.width < 2 ? impl.width : 2;
+    uint32_t body  = count - count % width;
+    impl.mul(m, in, out, 0, body);
+    mul_scalar(m, in, out, body, count);
+}
+
+TransformBackend transform_backend(void) {
+    pthread_once(&impl.once, select_best);
+    return impl.backend;
+}
+
+const char *transform_backend_name(TransformBackend backend) {
+    static const char *names[TRANSFORM_BACKEND_COUNT] = {
+        [TRANSFORM_SCALAR] = "scalar",
+        [TRANSFORM_SSE]    = "sse",
+        [TRANSFORM_AVX2]   = "avx2",
+    };
+    return backend < TRANSFORM_BACKEND_COUNT ? names[backend] : "unknown";
+}
+
+bool transform_use(TransformBackend backend) {
+    pthread_once(&impl.once, select_best);
+    if (!supported(backend)) return false;
+    select_backend(backend);
+    return true;
+}
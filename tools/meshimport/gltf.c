@@ -0,0 +1,302 @@
+// glTF 2.0 reader for .gltf (external or base64 data: URI buffers) and .glb.
+// Imports every triangle primitive of every mesh in its own object space:
+// POSITION, TEXCOORD_0 and indices. Node transforms and other attributes are
+// ignored; accessors without a bufferView (all zeros, or sparse) are rejected.
+#include "meshimport.h"
+#include "json.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define GLB_MAGIC      0x46546C67u  // "glTF"
+#define GLB_CHUNK_JSON 0x4E4F534Au
+#define GLB_CHUNK_BIN  0x004E4942u
+
+enum {
+    GLTF_BYTE           = 5120,
+    GLTF_UNSIGNED_BYTE  = 5121,
+    GLTF_SHORT          = 5122,
+    GLTF_UNSIGNED_SHORT = 5123,
+    GLTF_UNSIGNED_INT   = 5125,
+    GLTF_FLOAT          = 5126,
+};
+
+#define GLTF_MODE_TRIANGLES 4
+#define GLTF_MAX_BUFFERS    64
+
+typedef struct {
+    uint8_t *data;
+    size_t   size;
+} Blob;
+
+typedef struct {
+    const JsonValue *root;
+    Blob             buffers[GLTF_MAX_BUFFERS];
+    size_t           buffer_count;
+} Gltf;
+
+typedef struct {
+    const uint8_t *data;
+    uint32_t       count;
+    uint32_t       stride;
+    uint32_t       components;
+    int            component_type;
+    bool           normalized;
+} Accessor;
+
+static bool read_file(const char *path, Blob *out) {
+    FILE *file = fopen(path, "rb");
+    if (!file) return false;
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    out->data = malloc(size > 0 ? (size_t)size : 1);
+    out->size = size > 0 ? (size_t)size : 0;
+    bool ok = fread(out->data, 1, out->size, file) == out->size;
+    fclose(file);
+    return ok;
+}
+
+static int base64_value(char c) {
+    if (c >= 'A' && c <= 'Z') return c - 'A';
+    if (c >= 'a' && c <= 'z') return c - 'a' + 26;
+    if (c >= '0' && c <= '9') return c - '0' + 52;
+    if (c == '+') return 62;
+    if (c == '/') return 63;
+    return -1;
+}
+
+static Blob base64_decode(const char *text) {
+    size_t   length = strlen(text);
+    Blob     out    = { .data = malloc(length / 4 * 3 + 3) };
+    uint32_t bits   = 0;
+    int      nbits  = 0;
+    for (const char *c = text; *c; c++) {
+        int v = base64_value(*c);
+        if (v < 0) continue;
+        bits = (bits << 6) | (uint32_t)v;
+        nbits += 6;
+        if (nbits >= 8) {
+            nbits -= 8;
+            out.data[out.size++] = (uint8_t)(bits >> nbits);
+        }
+    }
+    return out;
+}
+
+// Resolve buffer URIs relative to the .gltf file's directory
+static bool load_buffers(Gltf *g, const char *path, const Blob *glb_bin) {
+    const JsonValue *buffers = json_get(g->root, "buffers");
+    for (size_t i = 0; buffers && i < buffers->count && i < GLTF_MAX_BUFFERS; i++) {
+        const JsonValue *uri = json_get(&buffers->children[i], "uri");
+        Blob            *out = &g->buffers[g->buffer_count++];
+
+        if (!uri) {
+            // The GLB binary chunk is buffer 0 and has no uri
+            if (!glb_bin) return false;
+            out->data = malloc(glb_bin->size);
+            out->size = glb_bin->size;
+            memcpy(out->data, glb_bin->data, glb_bin->size);
+        } else if (uri->type != JSON_STRING) {
+            fprintf(stderr, "%s: buffer %zu has a uri that is not a string\n", path, i);
+            return false;
+        } else if (strncmp(uri->string, "data:", 5) == 0) {
+            const char *payload = strstr(uri->string, ";base64,");
+            if (!payload) return false;
+            *out = base64_decode(payload + 8);
+        } else {
+            char        full[1024];
+            const char *slash = strrchr(path, '/');
+            int         dir   = slash ? (int)(slash - path + 1) : 0;
+            snprintf(full, sizeof(full), "%.*s%s", dir, path, uri->string);
+            if (!read_file(full, out)) {
+                fprintf(stderr, "%s: cannot read buffer %s\n", path, full);
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+static uint32_t type_components(const char *type) {
+    if (strcmp(type, "SCALAR") == 0) return 1;
+    if (strcmp(type, "VEC2") == 0)   return 2;
+    if (strcmp(type, "VEC3") == 0)   return 3;
+    if (strcmp(type, "VEC4") == 0)   return 4;
+    return 0;
+}
+
+static uint32_t component_size(int type) {
+    switch (type) {
+        case GLTF_BYTE: case GLTF_UNSIGNED_BYTE:   return 1;
+        case GLTF_SHORT: case GLTF_UNSIGNED_SHORT: return 2;
+        case GLTF_UNSIGNED_INT: case GLTF_FLOAT:   return 4;
+        default:                                   return 0;
+    }
+}
+
+// Optional unsigned member, fallback when missing; false if it is anything
+// but a 32-bit unsigned number
+static bool get_uint(const JsonValue *object, const char *key, uint32_t fallback, uint32_t *out) {
+    const JsonValue *v = json_get(object, key);
+    size_t           n = fallback;
+    if (v && !json_index(v, UINT32_MAX, &n)) return false;
+    *out = (uint32_t)n;
+    return true;
+}
+
+static bool get_accessor(const Gltf *g, const JsonValue *index, Accessor *out) {
+    const JsonValue *accessors = json_get(g->root, "accessors");
+    const JsonValue *views     = json_get(g->root, "bufferViews");
+    size_t           a, v, buffer;
+    if (!json_index(index, accessors ? accessors->count : 0, &a)) return false;
+    const JsonValue *acc  = json_at(accessors, a);
+    const JsonValue *type = json_get(acc, "type");
+    if (!acc || !type || type->type != JSON_STRING) return false;
+
+    // An accessor without a bufferView is all zeros (or sparse), not a mesh
+    if (!json_index(json_get(acc, "bufferView"), views ? views->count : 0, &v)) return false;
+    const JsonValue *view = json_at(views, v);
+    if (!view || !json_index(json_get(view, "buffer"), g->buffer_count, &buffer)) return false;
+
+    uint32_t component_type, view_offset, acc_offset;
+    *out = (Accessor){ .components = type_components(type->string) };
+    if (!get_uint(acc, "count", 0, &out->count) || !get_uint(acc, "componentType", 0, &component_type) ||
+        !get_uint(view, "byteOffset", 0, &view_offset) || !get_uint(acc, "byteOffset", 0, &acc_offset)) {
+        return false;
+    }
+    out->component_type = (int)component_type;
+    const JsonValue *normalized = json_get(acc, "normalized");
+    out->normalized = normalized && normalized->type == JSON_BOOL && normalized->boolean;
+
+    uint32_t elem = out->components * component_size(out->component_type);
+    if (elem == 0 || !get_uint(view, "byteStride", elem, &out->stride)) return false;
+
+    uint64_t offset = (uint64_t)view_offset + acc_offset;
+    uint64_t span   = out->count ? (uint64_t)(out->count - 1) * out->stride + elem : 0;
+    if (offset + span > g->buffers[buffer].size) return false;
+    out->data = g->buffers[buffer].data + offset;
+    return true;
+}
+
+static float read_component(const Accessor *a, uint32_t i, uint32_t c) {
+    const uint8_t *p = a->data + (size_t)i * a->stride;
+    switch (a->component_type) {
+        case GLTF_FLOAT: {
+            float v;
+            memcpy(&v, p + c * 4, 4);
+            return v;
+        }
+        case GLTF_UNSIGNED_BYTE: {
+            float v = p[c];
+            return a->normalized ? v / 255.0f : v;
+        }
+        case GLTF_UNSIGNED_SHORT: {
+            uint16_t v;
+            memcpy(&v, p + c * 2, 2);
+            return a->normalized ? v / 65535.0f : v;
+        }
+        default:
+            return 0.0f;
+    }
+}
+
+static uint32_t read_index(const Accessor *a, uint32_t i) {
+    const uint8_t *p = a->data + (size_t)i * a->stride;
+    switch (a->component_type) {
+        case GLTF_UNSIGNED_BYTE:  return p[0];
+        case GLTF_UNSIGNED_SHORT: { uint16_t v; memcpy(&v, p, 2); return v; }
+        case GLTF_UNSIGNED_INT:   { uint32_t v; memcpy(&v, p, 4); return v; }
+        default:                  return 0;
+    }
+}
+
+static bool import_primitive(ImportMesh *mesh, const Gltf *g, const JsonValue *prim) {
+    if (json_number(prim, "mode", GLTF_MODE_TRIANGLES) != GLTF_MODE_TRIANGLES) return true;
+
+    const JsonValue *attrs = json_get(prim, "attributes");
+    const JsonValue *pos_index = json_get(attrs, "POSITION");
+    const JsonValue *uv_index  = json_get(attrs, "TEXCOORD_0");
+    const JsonValue *indices   = json_get(prim, "indices");
+
+    Accessor pos, uv, idx;
+    if (!get_accessor(g, pos_index, &pos) || pos.components != 3) return false;
+    bool has_uv  = uv_index && get_accessor(g, uv_index, &uv) && uv.components == 2 && uv.count == pos.count;
+    bool has_idx = indices && get_accessor(g, indices, &idx) && idx.components == 1;
+
+    uint32_t corners = has_idx ? idx.count : pos.count;
+    corners -= corners % 3;
+    mesh->vertices = realloc(mesh->vertices, (size_t)(mesh->vertex_count + corners) * sizeof(MeshVertex));
+
+    for (uint32_t i = 0; i < corners; i++) {
+        uint32_t v = has_idx ? read_index(&idx, i) : i;
+        if (v >= pos.count) return false;
+
+        MeshVertex *out = &mesh->vertices[mesh->vertex_count++];
+        for (uint32_t c = 0; c < 3; c++) out->position[c] = read_component(&pos, v, c);
+        // glTF puts the UV origin top-left; the engine's is bottom-left
+        out->uv[0] = has_uv ? read_component(&uv, v, 0) : 0.0f;
+        out->uv[1] = has_uv ? 1.0f - read_component(&uv, v, 1) : 0.0f;
+    }
+    return true;
+}
+
+bool import_gltf(ImportMesh *mesh, const char *path) {
+    Blob file;
+    if (!read_file(path, &file)) {
+        fprintf(stderr, "%s: cannot open\n", path);
+        return false;
+    }
+
+    // GLB: 12 byte header, then a JSON chunk and an optional BIN chunk
+    const char *json      = (const char *)file.data;
+    size_t      json_size = file.size;
+    Blob        bin       = {0};
+    bool        is_glb    = false;
+    uint32_t    words[5];
+    if (file.size >= 20) {
+        memcpy(words, file.data, sizeof(words));
+        if (words[0] == GLB_MAGIC && words[4] == GLB_CHUNK_JSON && 20 + (size_t)words[3] <= file.size) {
+            is_glb    = true;
+            json      = (const char *)file.data + 20;
+            json_size = words[3];
+            size_t bin_at = 20 + json_size;
+            uint32_t chunk[2];
+            if (bin_at + 8 <= file.size) {
+                memcpy(chunk, file.data + bin_at, sizeof(chunk));
+                if (chunk[1] == GLB_CHUNK_BIN && bin_at + 8 + chunk[0] <= file.size) {
+                    bin = (Blob){ file.data + bin_at + 8, chunk[0] };
+                }
+            }
+        }
+    }
+
+    Gltf g = { .root = json_parse(json, json_size) };
+    bool ok = g.root != NULL;
+    if (!ok) fprintf(stderr, "%s: invalid JSON\n", path);
+
+    ok = ok && load_buffers(&g, path, is_glb ? &bin : NULL);
+
+    const JsonValue *meshes = json_get(g.root, "meshes");
+    for (size_t m = 0; ok && meshes && m < meshes->count; m++) {
+        const JsonValue *prims = json_get(&meshes->children[m], "primitives");
+        for (size_t p = 0; ok && prims && p < prims->count; p++) {
+            ok = import_primitive(mesh, &g, &prims->children[p]);
+            if (!ok) fprintf(stderr, "%s: mesh %zu primitive %zu: bad accessor\n", path, m, p);
+        }
+    }
+    if (ok && mesh->vertex_count == 0) {
+        fprintf(stderr, "%s: no triangles\n", path);
+        ok = false;
+    }
+
+    for (size_t i = 0; i < g.buffer_count; i++) free(g.buffers[i].data);
+    json_free((JsonValue *)g.root);
+    free(file.data);
+
+    // One vertex per corner for now
+    mesh->index_count = mesh->vertex_count;
+    mesh->indices     = malloc((size_t)mesh->index_count * sizeof(uint32_t));
+    for (uint32_t i = 0; i < mesh->index_count; i++) mesh->indices[i] = i;
+    return ok;
+}
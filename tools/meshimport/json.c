@@ -0,0 +1,215 @@
+#include "json.h"
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+    const char *p;
+    const char *end;
+    bool        failed;
+} Parser;
+
+static bool parse_value(Parser *ps, JsonValue *out);
+
+static void skip_space(Parser *ps) {
+    while (ps->p < ps->end && (*ps->p == ' ' || *ps->p == '\t' || *ps->p == '\n' || *ps->p == '\r')) {
+        ps->p++;
+    }
+}
+
+static bool expect(Parser *ps, char c) {
+    skip_space(ps);
+    if (ps->p < ps->end && *ps->p == c) {
+        ps->p++;
+        return true;
+    }
+    return false;
+}
+
+static bool match_word(Parser *ps, const char *word) {
+    size_t n = strlen(word);
+    if ((size_t)(ps->end - ps->p) < n || memcmp(ps->p, word, n) != 0) return false;
+    ps->p += n;
+    return true;
+}
+
+static void put_utf8(char **dst, unsigned cp) {
+    char *d = *dst;
+    if (cp < 0x80) {
+        *d++ = (char)cp;
+    } else if (cp < 0x800) {
+        *d++ = (char)(0xC0 | (cp >> 6));
+        *d++ = (char)(0x80 | (cp & 0x3F));
+    } else {
+        *d++ = (char)(0xE0 | (cp >> 12));
+        *d++ = (char)(0x80 | ((cp >> 6) & 0x3F));
+        *d++ = (char)(0x80 | (cp & 0x3F));
+    }
+    *dst = d;
+}
+
+// Parses a string starting at the opening quote. Escapes only ever shrink,
+// so the raw length bounds the output.
+static char *parse_string(Parser *ps) {
+    if (!expect(ps, '"')) return NULL;
+    const char *start = ps->p;
+    while (ps->p < ps->end && *ps->p != '"') {
+        if (*ps->p == '\\') ps->p++;
+        ps->p++;
+    }
+    if (ps->p >= ps->end) return NULL;
+
+    char *out = malloc((size_t)(ps->p - start) + 1);
+    char *d   = out;
+    for (const char *s = start; s < ps->p; s++) {
+        if (*s != '\\') {
+            *d++ = *s;
+            continue;
+        }
+        s++;
+        switch (*s) {
+            case 'b': *d++ = '\b'; break;
+            case 'f': *d++ = '\f'; break;
+            case 'n': *d++ = '\n'; break;
+            case 'r': *d++ = '\r'; break;
+            case 't': *d++ = '\t'; break;
+            case 'u': {
+                unsigned cp = 0;
+                for (int i = 0; i < 4 && s + 1 < ps->p; i++) {
+                    char c = *++s;
+                    cp <<= 4;
+                    if      (c >= '0' && c <= '9') cp |= (unsigned)(c - '0');
+                    else if (c >= 'a' && c <= 'f') cp |= (unsigned)(c - 'a' + 10);
+                    else if (c >= 'A' && c <= 'F') cp |= (unsigned)(c - 'A' + 10);
+                }
+                put_utf8(&d, cp);
+                break;
+            }
+            default: *d++ = *s; break;
+        }
+    }
+    *d = '\0';
+    ps->p++;
+    return out;
+}
+
+// Parses '[' ... ']' or '{' ... '}' into a growing child array
+static bool parse_container(Parser *ps, JsonValue *out, char close, bool members) {
+    size_t capacity = 0;
+    skip_space(ps);
+    if (expect(ps, close)) return true;
+
+    do {
+        if (out->count == capacity) {
+            capacity = capacity ? capacity * 2 : 8;
+            out->children = realloc(out->children, capacity * sizeof(JsonValue));
+        }
+        JsonValue *child = &out->children[out->count];
+        *child = (JsonValue){0};
+        out->count++;
+
+        if (members) {
+            skip_space(ps);
+            child->key = parse_string(ps);
+            if (!child->key || !expect(ps, ':')) return false;
+        }
+        if (!parse_value(ps, child)) return false;
+    } while (expect(ps, ','));
+
+    return expect(ps, close);
+}
+
+static bool parse_value(Parser *ps, JsonValue *out) {
+    skip_space(ps);
+    if (ps->p >= ps->end) return false;
+
+    switch (*ps->p) {
+        case '{':
+            ps->p++;
+            out->type = JSON_OBJECT;
+            return parse_container(ps, out, '}', true);
+        case '[':
+            ps->p++;
+            out->type = JSON_ARRAY;
+            return parse_container(ps, out, ']', false);
+        case '"':
+            out->type   = JSON_STRING;
+            out->string = parse_string(ps);
+            return out->string != NULL;
+        case 't':
+            out->type    = JSON_BOOL;
+            out->boolean = true;
+            return match_word(ps, "true");
+        case 'f':
+            out->type = JSON_BOOL;
+            return match_word(ps, "false");
+        case 'n':
+            out->type = JSON_NULL;
+            return match_word(ps, "null");
+        default: {
+            // strtod needs a terminated buffer; numbers are short
+            char buf[64];
+            size_t n = 0;
+            while (ps->p + n < ps->end && n < sizeof(buf) - 1 && strchr("+-0123456789.eE", ps->p[n])) n++;
+            if (n == 0) return false;
+            memcpy(buf, ps->p, n);
+            buf[n] = '\0';
+            out->type   = JSON_NUMBER;
+            out->number = strtod(buf, NULL);
+            ps->p += n;
+            return true;
+        }
+    }
+}
+
+static void free_children(JsonValue *value) {
+    for (size_t i = 0; i < value->count; i++) {
+        free_children(&value->children[i]);
+        free(value->children[i].key);
+    }
+    free(value->children);
+    free(value->string);
+}
+
+JsonValue *json_parse(const char *text, size_t length) {
+    Parser     ps   = { .p = text, .end = text + length };
+    JsonValue *root = calloc(1, sizeof(JsonValue));
+    if (!parse_value(&ps, root)) {
+        json_free(root);
+        return NULL;
+    }
+    return root;
+}
+
+void json_free(JsonValue *value) {
+    if (!value) return;
+    free_children(value);
+    free(value);
+}
+
+const JsonValue *json_get(const JsonValue *object, const char *key) {
+    if (!object || object->type != JSON_OBJECT) return NULL;
+    for (size_t i = 0; i < object->count; i++) {
+        if (strcmp(object->children[i].key, key) == 0) return &object->children[i];
+    }
+    return NULL;
+}
+
+const JsonValue *json_at(const JsonValue *array, size_t index) {
+    if (!array || array->type != JSON_ARRAY || index >= array->count) return NULL;
+    return &array->children[index];
+}
+
+double json_number(const JsonValue *object, const char *key, double fallback) {
+    const JsonValue *v = json_get(object, key);
+    return v && v->type == JSON_NUMBER ? v->number : fallback;
+}
+
+bool json_index(const JsonValue *value, size_t limit, size_t *out) {
+    // Checked as a double first, since converting one out of range is undefined
+    if (!value || value->type != JSON_NUMBER || !(value->number >= 0.0) || value->number >= (double)limit ||
+        value->number != (double)(size_t)value->number) {
+        return false;
+    }
+    *out = (size_t)value->number;
+    return true;
+}
@@ -0,0 +1,46 @@
+#ifndef JSON_H
+#define JSON_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// Minimal read-only JSON DOM, enough for glTF
+
+typedef enum {
+    JSON_NULL,
+    JSON_BOOL,
+    JSON_NUMBER,
+    JSON_STRING,
+    JSON_ARRAY,
+    JSON_OBJECT,
+} JsonType;
+
+typedef struct JsonValue JsonValue;
+struct JsonValue {
+    JsonType   type;
+    bool       boolean;
+    double     number;
+    char      *string;     // JSON_STRING value, NUL terminated
+    char      *key;        // set on object members
+    JsonValue *children;   // array elements or object members
+    size_t     count;
+};
+
+// Parse text (length bytes). Returns NULL on a syntax error.
+JsonValue       *json_parse(const char *text, size_t length);
+void             json_free(JsonValue *value);
+
+// Object member by key, or NULL
+const JsonValue *json_get(const JsonValue *object, const char *key);
+
+// Array element, or NULL when out of range
+const JsonValue *json_at(const JsonValue *array, size_t index);
+
+// Number member with a default when missing
+double           json_number(const JsonValue *object, const char *key, double fallback);
+
+// Whole number in [0, limit), e.g. an index into an array of limit elements.
+// False if value is missing, not a number or out of range.
+bool             json_index(const JsonValue *value, size_t limit, size_t *out);
+
+#endif // JSON_H
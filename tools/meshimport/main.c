@@ -0,0 +1,186 @@
+// Offline mesh importer: reads OBJ or glTF, welds duplicate vertices,
+// reorders triangles for the post-transform cache and vertices for fetch
+// locality, simplifies it into a chain of levels of detail, splits each level
+// into meshlets, then writes the engine's mesh format (see mesh_format.h).
+//
+//   meshimport <input.obj|.gltf|.glb> <output.mesh>
+#include "meshimport.h"
+#include <float.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Each LOD aims for this fraction of the previous one's triangles. The chain
+// ends at the first level that keeps more than LOD_MIN_REDUCTION of them.
+#define LOD_REDUCTION     0.5f
+#define LOD_MIN_REDUCTION 0.85f
+
+static uint32_t align_up(uint32_t v) {
+    return (v + MESH_ALIGN - 1) & ~(uint32_t)(MESH_ALIGN - 1);
+}
+
+static bool has_extension(const char *path, const char *ext) {
+    size_t n = strlen(path), e = strlen(ext);
+    return n >= e && strcmp(path + n - e, ext) == 0;
+}
+
+static void compute_bounds(const ImportMesh *mesh, MeshHeader *h) {
+    for (int c = 0; c < 3; c++) {
+        h->bounds_min[c] =  FLT_MAX;
+        h->bounds_max[c] = -FLT_MAX;
+    }
+    for (uint32_t i = 0; i < mesh->vertex_count; i++) {
+        for (int c = 0; c < 3; c++) {
+            float p = mesh->vertices[i].position[c];
+            if (p < h->bounds_min[c]) h->bounds_min[c] = p;
+            if (p > h->bounds_max[c]) h->bounds_max[c] = p;
+        }
+    }
+
+    // Sphere around the box centre: not minimal, but tight enough for culling
+    float r2 = 0.0f;
+    for (int c = 0; c < 3; c++) h->sphere_center[c] = 0.5f * (h->bounds_min[c] + h->bounds_max[c]);
+    for (uint32_t i = 0; i < mesh->vertex_count; i++) {
+        float d2 = 0.0f;
+        for (int c = 0; c < 3; c++) {
+            float d = mesh->vertices[i].position[c] - h->sphere_center[c];
+            d2 += d * d;
+        }
+        if (d2 > r2) r2 = d2;
+    }
+    h->sphere_radius = sqrtf(r2);
+}
+
+// Append coarser levels after LOD 0 in mesh->indices, each simplified from
+// the one before. Returns the number of levels, LOD 0 included.
+static uint32_t build_lods(ImportMesh *mesh, MeshLod lods[MESH_MAX_LODS]) {
+    lods[0] = (MeshLod){ .first_index = 0, .index_count = mesh->index_count, .error = 0.0f };
+    uint32_t count = 1;
+    while (count < MESH_MAX_LODS) {
+        const MeshLod *prev   = &lods[count - 1];
+        uint32_t       target = (uint32_t)((float)(prev->index_count / 3) * LOD_REDUCTION) * 3;
+        uint32_t      *lod    = malloc((size_t)prev->index_count * sizeof(uint32_t));
+        float          error  = 0.0f;
+        uint32_t       n      = mesh_simplify(mesh, mesh->indices + prev->first_index, prev->index_count, target,
+                                              lod, &error);
+        if (n == 0 || (float)n > (float)prev->index_count * LOD_MIN_REDUCTION) {
+            free(lod);
+            break;
+        }
+
+        // Cache order within the level; vertices keep LOD 0's fetch order
+        ImportMesh level = { .vertices = mesh->vertices, .vertex_count = mesh->vertex_count,
+                             .indices = lod, .index_count = n };
+        mesh_optimize_vcache(&level);
+
+        mesh->indices = realloc(mesh->indices, ((size_t)mesh->index_count + n) * sizeof(uint32_t));
+        memcpy(mesh->indices + mesh->index_count, lod, (size_t)n * sizeof(uint32_t));
+        // Errors are measured against the previous level, so they add up
+        lods[count++] = (MeshLod){ .first_index = mesh->index_count, .index_count = n,
+                                   .error = prev->error + error };
+        mesh->index_count += n;
+        free(lod);
+    }
+    return count;
+}
+
+static bool write_mesh(const ImportMesh *mesh, const MeshLod *lods, uint32_t lod_count,
+                       const Meshlet *meshlets, uint32_t meshlet_count, const char *path) {
+    uint32_t   index_size = mesh->vertex_count <= UINT16_MAX ? 2 : 4;
+    MeshHeader h = {
+        .magic         = MESH_MAGIC,
+        .version       = MESH_VERSION,
+        .vertex_count  = mesh->vertex_count,
+        .vertex_stride = sizeof(MeshVertex),
+        .vertex_offset = align_up(sizeof(MeshHeader)),
+        .index_count   = mesh->index_count,
+        .index_size    = index_size,
+        .meshlet_count = meshlet_count,
+        .lod_count     = lod_count,
+    };
+    memcpy(h.lods, lods, lod_count * sizeof(MeshLod));
+    h.index_offset   = align_up(h.vertex_offset + mesh->vertex_count * (uint32_t)sizeof(MeshVertex));
+    h.meshlet_offset = align_up(h.index_offset + mesh->index_count * index_size);
+    uint32_t size    = h.meshlet_offset + meshlet_count * (uint32_t)sizeof(Meshlet);
+    compute_bounds(mesh, &h);
+
+    uint8_t *file = calloc(1, size);
+    memcpy(file, &h, sizeof(h));
+    memcpy(file + h.vertex_offset, mesh->vertices, (size_t)mesh->vertex_count * sizeof(MeshVertex));
+    for (uint32_t i = 0; i < mesh->index_count; i++) {
+        if (index_size == 2) {
+            uint16_t v = (uint16_t)mesh->indices[i];
+            memcpy(file + h.index_offset + i * 2, &v, 2);
+        } else {
+            memcpy(file + h.index_offset + i * 4, &mesh->indices[i], 4);
+        }
+    }
+    memcpy(file + h.meshlet_offset, meshlets, (size_t)meshlet_count * sizeof(Meshlet));
+
+    FILE *out = fopen(path, "wb");
+    bool  ok  = out && fwrite(file, 1, size, out) == size;
+    if (out) fclose(out);
+    free(file);
+    if (!ok) fprintf(stderr, "%s: write failed\n", path);
+    return ok;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc != 3) {
+        fprintf(stderr, "usage: %s <input.obj|.gltf|.glb> <output.mesh>\n", argv[0]);
+        return 1;
+    }
+    const char *input  = argv[1];
+    const char *output = argv[2];
+
+    ImportMesh mesh = {0};
+    bool ok = has_extension(input, ".obj") ? import_obj(&mesh, input)
+                                           : import_gltf(&mesh, input);
+    if (!ok) {
+        import_mesh_free(&mesh);
+        return 1;
+    }
+
+    uint32_t corners = mesh.vertex_count;
+    mesh_weld(&mesh);
+    float acmr_before    = mesh_acmr(&mesh, VCACHE_SIZE);
+    float acmr_before_16 = mesh_acmr(&mesh, 16);
+
+    mesh_optimize_vcache(&mesh);
+    mesh_optimize_vfetch(&mesh);
+
+    printf("%s: %u triangles, %u corners welded to %u vertices\n",
+           input, mesh.index_count / 3, corners, mesh.vertex_count);
+
+    MeshLod  lods[MESH_MAX_LODS];
+    uint32_t lod_count = build_lods(&mesh, lods);
+    for (uint32_t l = 1; l < lod_count; l++) {
+        printf("  LOD %u: %u triangles, error %.4f\n", l, lods[l].index_count / 3, lods[l].error);
+    }
+
+    Meshlet *meshlets      = malloc((size_t)(mesh.index_count / 3) * sizeof(Meshlet));
+    uint32_t meshlet_count = 0;
+    for (uint32_t l = 0; l < lod_count; l++) {
+        lods[l].first_meshlet = meshlet_count;
+        lods[l].meshlet_count = mesh_build_meshlets(&mesh, lods[l].first_index, lods[l].index_count,
+                                                    meshlets + meshlet_count);
+        meshlet_count += lods[l].meshlet_count;
+    }
+    printf("  %u meshlets, %.1f triangles each\n", lods[0].meshlet_count,
+           (double)(lods[0].index_count / 3) / lods[0].meshlet_count);
+
+    // Triangles moved, so lay vertices out in their new first-use order
+    mesh_optimize_vfetch(&mesh);
+
+    // LOD 0 as written, after meshlets regrouped its triangles
+    ImportMesh lod0 = { .vertices = mesh.vertices, .vertex_count = mesh.vertex_count,
+                        .indices = mesh.indices, .index_count = lods[0].index_count };
+    printf("  ACMR (FIFO %2d): %.3f -> %.3f\n", VCACHE_SIZE, acmr_before, mesh_acmr(&lod0, VCACHE_SIZE));
+    printf("  ACMR (FIFO %2d): %.3f -> %.3f\n", 16, acmr_before_16, mesh_acmr(&lod0, 16));
+
+    ok = write_mesh(&mesh, lods, lod_count, meshlets, meshlet_count, output);
+    free(meshlets);
+    import_mesh_free(&mesh);
+    return ok ? 0 : 1;
+}
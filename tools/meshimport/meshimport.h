@@ -0,0 +1,55 @@
+#ifndef MESHIMPORT_H
+#define MESHIMPORT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "mesh_format.h"
+
+// Triangle list being imported, always with 32-bit indices until written
+typedef struct {
+    MeshVertex *vertices;
+    uint32_t    vertex_count;
+    uint32_t   *indices;
+    uint32_t    index_count;
+} ImportMesh;
+
+// Post-transform cache size assumed by the optimizer and ACMR report
+#define VCACHE_SIZE 32
+
+// Readers. Return false (and print why) on failure. Both produce one vertex
+// per triangle corner; mesh_weld() merges the duplicates.
+bool  import_obj (ImportMesh *mesh, const char *path);
+bool  import_gltf(ImportMesh *mesh, const char *path);
+
+void  import_mesh_free(ImportMesh *mesh);
+
+// Merge bit-identical vertices and rewrite the indices
+void  mesh_weld(ImportMesh *mesh);
+
+// Reorder triangles for post-transform cache hits (Forsyth's algorithm)
+void  mesh_optimize_vcache(ImportMesh *mesh);
+
+// Renumber vertices in first-use order so fetches walk memory linearly.
+// Drops vertices no triangle references.
+void  mesh_optimize_vfetch(ImportMesh *mesh);
+
+// Simplify a triangle list over mesh's vertices towards target_index_count
+// indices by quadric-error edge collapses onto existing vertices (see
+// simplify.c). Writes the result to out, which needs room for index_count,
+// and returns its index count; *error receives the largest distance a
+// collapse moved the surface, in model units. Stops short of the target once
+// nothing more can collapse.
+uint32_t mesh_simplify(const ImportMesh *mesh, const uint32_t *indices, uint32_t index_count,
+                       uint32_t target_index_count, uint32_t *out, float *error);
+
+// Split the triangles [first_index, first_index + index_count) of mesh into
+// compact meshlets (see meshlet.c) and compute their bounds and normal
+// cones. Reorders the range so each meshlet is one run of it. Writes at most
+// index_count / 3 meshlets to out and returns how many.
+uint32_t mesh_build_meshlets(ImportMesh *mesh, uint32_t first_index, uint32_t index_count, Meshlet *out);
+
+// Average cache miss ratio: vertex shader invocations per triangle for a
+// FIFO post-transform cache of cache_size entries. 3.0 is the worst case.
+float mesh_acmr(const ImportMesh *mesh, uint32_t cache_size);
+
+#endif // MESHIMPORT_H
@@ -0,0 +1,170 @@
+#include "meshimport.h"
+#include <float.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+// --- Meshlets ----------------------------------------------------------------
+//
+// Each meshlet grows from a seed triangle by repeatedly taking the
+// neighbouring triangle that adds the fewest new vertices, nearest the
+// meshlet's centre on a tie, until the vertex or triangle limit is hit or
+// no neighbour is left. Compact, round meshlets keep bounding spheres small
+// and normal cones narrow, which is what culling them needs. Seeds are taken
+// in the cache optimizer's order, and each meshlet's triangles are cache
+// ordered again once it is built.
+
+// Bounding sphere around the box centre, and the cone around the average
+// triangle normal that holds them all
+static void compute_meshlet_bounds(const ImportMesh *mesh, Meshlet *m) {
+    const uint32_t *indices = mesh->indices + m->first_index;
+    float lo[3] = { FLT_MAX, FLT_MAX, FLT_MAX }, hi[3] = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+    for (uint32_t i = 0; i < m->index_count; i++) {
+        const float *p = mesh->vertices[indices[i]].position;
+        for (int c = 0; c < 3; c++) {
+            if (p[c] < lo[c]) lo[c] = p[c];
+            if (p[c] > hi[c]) hi[c] = p[c];
+        }
+    }
+    float r2 = 0.0f;
+    for (int c = 0; c < 3; c++) m->center[c] = 0.5f * (lo[c] + hi[c]);
+    for (uint32_t i = 0; i < m->index_count; i++) {
+        const float *p  = mesh->vertices[indices[i]].position;
+        float        d2 = 0.0f;
+        for (int c = 0; c < 3; c++) d2 += (p[c] - m->center[c]) * (p[c] - m->center[c]);
+        if (d2 > r2) r2 = d2;
+    }
+    m->radius = sqrtf(r2);
+
+    // Unit normals of the non-degenerate triangles
+    float    normals[MESHLET_MAX_TRIANGLES][3];
+    uint32_t count   = 0;
+    float    axis[3] = { 0.0f, 0.0f, 0.0f };
+    for (uint32_t t = 0; t < m->index_count; t += 3) {
+        const float *a = mesh->vertices[indices[t]].position;
+        const float *b = mesh->vertices[indices[t + 1]].position;
+        const float *c = mesh->vertices[indices[t + 2]].position;
+        float u[3] = { b[0] - a[0], b[1] - a[1], b[2] - a[2] };
+        float v[3] = { c[0] - a[0], c[1] - a[1], c[2] - a[2] };
+        float n[3] = { u[1] * v[2] - u[2] * v[1], u[2] * v[0] - u[0] * v[2], u[0] * v[1] - u[1] * v[0] };
+        float len  = sqrtf(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+        if (len == 0.0f) continue;
+        for (int k = 0; k < 3; k++) {
+            normals[count][k] = n[k] / len;
+            axis[k]          += n[k] / len;
+        }
+        count++;
+    }
+    float len = sqrtf(axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2]);
+    float min_dot = 1.0f;
+    for (int k = 0; k < 3; k++) m->cone_axis[k] = len > 0.0f ? axis[k] / len : 0.0f;
+    for (uint32_t t = 0; t < count; t++) {
+        float d = normals[t][0] * m->cone_axis[0] + normals[t][1] * m->cone_axis[1] + normals[t][2] * m->cone_axis[2];
+        if (d < min_dot) min_dot = d;
+    }
+
+    // The cone's half-angle is acos(min_dot); the meshlet faces away from
+    // directions within 90 degrees minus that of the axis. Nearly flat-open
+    // cones would only cull from almost exactly behind, so don't bother.
+    m->cone_cutoff = len == 0.0f || min_dot <= 0.1f ? 1.0f : sqrtf(1.0f - min_dot * min_dot);
+}
+
+typedef struct {
+    uint32_t *start;     // triangles around each vertex, CSR
+    uint32_t *list;
+    uint32_t *stamp;     // meshlet number + 1 a vertex was last added to
+    bool     *emitted;
+} MeshletBuilder;
+
+static void triangle_centroid(const ImportMesh *mesh, const uint32_t *tri, float c[3]) {
+    for (int k = 0; k < 3; k++) {
+        c[k] = (mesh->vertices[tri[0]].position[k] + mesh->vertices[tri[1]].position[k] +
+                mesh->vertices[tri[2]].position[k]) / 3.0f;
+    }
+}
+
+uint32_t mesh_build_meshlets(ImportMesh *mesh, uint32_t first_index, uint32_t index_count, Meshlet *out) {
+    const uint32_t *indices        = mesh->indices + first_index;
+    uint32_t        triangle_count = index_count / 3;
+    MeshletBuilder  b = {
+        .start   = calloc((size_t)mesh->vertex_count + 1, sizeof(uint32_t)),
+        .list    = malloc((size_t)index_count * sizeof(uint32_t)),
+        .stamp   = calloc(mesh->vertex_count, sizeof(uint32_t)),
+        .emitted = calloc(triangle_count, sizeof(bool)),
+    };
+    uint32_t *order = malloc((size_t)index_count * sizeof(uint32_t));
+    for (uint32_t i = 0; i < index_count; i++) b.start[indices[i] + 1]++;
+    for (uint32_t v = 0; v < mesh->vertex_count; v++) b.start[v + 1] += b.start[v];
+    for (uint32_t i = 0; i < index_count; i++) b.list[b.start[indices[i]]++] = i / 3;
+    for (uint32_t v = mesh->vertex_count; v > 0; v--) b.start[v] = b.start[v - 1];
+    b.start[0] = 0;
+
+    uint32_t count   = 0;
+    uint32_t written = 0;
+    uint32_t seed    = 0;
+    while (written < index_count) {
+        while (b.emitted[seed]) seed++;
+        Meshlet *m = &out[count++];
+        *m = (Meshlet){ .first_index = first_index + written };
+        uint32_t vertices[MESHLET_MAX_VERTICES];
+        uint32_t vertex_count = 0;
+        float    center[3]    = { 0.0f, 0.0f, 0.0f };
+        uint32_t next         = seed;
+        while (next != UINT32_MAX) {
+            const uint32_t *tri = &indices[next * 3];
+            b.emitted[next] = true;
+            for (int k = 0; k < 3; k++) {
+                order[written++] = tri[k];
+                if (b.stamp[tri[k]] != count) {
+                    b.stamp[tri[k]]          = count;
+                    vertices[vertex_count++] = tri[k];
+                }
+            }
+            float c[3];
+            triangle_centroid(mesh, tri, c);
+            m->index_count += 3;
+            uint32_t n = m->index_count / 3;
+            for (int k = 0; k < 3; k++) center[k] += (c[k] - center[k]) / (float)n;
+            if (n == MESHLET_MAX_TRIANGLES) break;
+
+            // Best unemitted triangle around the meshlet's vertices that fits
+            next = UINT32_MAX;
+            uint32_t best_added = 4;
+            float    best_d2    = 0.0f;
+            for (uint32_t i = 0; i < vertex_count; i++) {
+                uint32_t v = vertices[i];
+                for (uint32_t j = b.start[v]; j < b.start[v + 1]; j++) {
+                    uint32_t t = b.list[j];
+                    if (b.emitted[t]) continue;
+                    const uint32_t *cand  = &indices[t * 3];
+                    uint32_t        added = (b.stamp[cand[0]] != count) + (b.stamp[cand[1]] != count) +
+                                            (b.stamp[cand[2]] != count);
+                    if (vertex_count + added > MESHLET_MAX_VERTICES || added > best_added) continue;
+                    triangle_centroid(mesh, cand, c);
+                    float d2 = 0.0f;
+                    for (int k = 0; k < 3; k++) d2 += (c[k] - center[k]) * (c[k] - center[k]);
+                    if (added < best_added || d2 < best_d2) {
+                        next       = t;
+                        best_added = added;
+                        best_d2    = d2;
+                    }
+                }
+            }
+        }
+    }
+    // Growing by distance loses the cache order; restore it within each run
+    memcpy(mesh->indices + first_index, order, (size_t)index_count * sizeof(uint32_t));
+    for (uint32_t i = 0; i < count; i++) {
+        ImportMesh run = { .vertices = mesh->vertices, .vertex_count = mesh->vertex_count,
+                           .indices = mesh->indices + out[i].first_index, .index_count = out[i].index_count };
+        mesh_optimize_vcache(&run);
+        compute_meshlet_bounds(mesh, &out[i]);
+    }
+
+    free(order);
+    free(b.emitted);
+    free(b.stamp);
+    free(b.list);
+    free(b.start);
+    return count;
+}
@@ -0,0 +1,123 @@
+// Wavefront OBJ reader: v, vt and f records. Polygons are fan-triangulated;
+// normals, groups and materials are ignored.
+#include "meshimport.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+    float   *data;
+    uint32_t count;     // in elements of `width` floats
+    uint32_t capacity;
+} FloatArray;
+
+static void float_push(FloatArray *a, const float *v, uint32_t width) {
+    if (a->count == a->capacity) {
+        a->capacity = a->capacity ? a->capacity * 2 : 1024;
+        a->data     = realloc(a->data, (size_t)a->capacity * width * sizeof(float));
+    }
+    memcpy(a->data + (size_t)a->count * width, v, width * sizeof(float));
+    a->count++;
+}
+
+static void vertex_push(ImportMesh *mesh, uint32_t *capacity, MeshVertex v) {
+    if (mesh->vertex_count == *capacity) {
+        *capacity      = *capacity ? *capacity * 2 : 1024;
+        mesh->vertices = realloc(mesh->vertices, (size_t)*capacity * sizeof(MeshVertex));
+    }
+    mesh->vertices[mesh->vertex_count++] = v;
+}
+
+// OBJ indices are 1-based, negative ones count back from the end
+static bool resolve(long index, uint32_t count, uint32_t *out) {
+    long i = index < 0 ? (long)count + index : index - 1;
+    if (i < 0 || i >= (long)count) return false;
+    *out = (uint32_t)i;
+    return true;
+}
+
+// Parse one "v", "v/t", "v//n" or "v/t/n" corner
+static bool parse_corner(const char **cursor, const FloatArray *pos, const FloatArray *uv, MeshVertex *out) {
+    char *end;
+    long  vi = strtol(*cursor, &end, 10);
+    if (end == *cursor) return false;
+
+    uint32_t p;
+    if (!resolve(vi, pos->count, &p)) return false;
+    memcpy(out->position, pos->data + p * 3, sizeof(out->position));
+    out->uv[0] = out->uv[1] = 0.0f;
+
+    if (*end == '/') {
+        end++;
+        if (*end != '/') {
+            long     ti = strtol(end, &end, 10);
+            uint32_t t;
+            if (resolve(ti, uv->count, &t)) memcpy(out->uv, uv->data + t * 2, sizeof(out->uv));
+        }
+        if (*end == '/') strtol(end + 1, &end, 10);
+    }
+    *cursor = end;
+    return true;
+}
+
+bool import_obj(ImportMesh *mesh, const char *path) {
+    FILE *file = fopen(path, "r");
+    if (!file) {
+        fprintf(stderr, "%s: cannot open\n", path);
+        return false;
+    }
+
+    FloatArray pos = {0}, uv = {0};
+    uint32_t   capacity = 0;
+    char       line[1024];
+    int        line_number = 0;
+    bool       ok = true;
+
+    while (ok && fgets(line, sizeof(line), file)) {
+        line_number++;
+        if (line[0] == 'v' && line[1] == ' ') {
+            float v[3] = {0};
+            sscanf(line + 2, "%f %f %f", &v[0], &v[1], &v[2]);
+            float_push(&pos, v, 3);
+        } else if (line[0] == 'v' && line[1] == 't' && line[2] == ' ') {
+            float t[2] = {0};
+            sscanf(line + 3, "%f %f", &t[0], &t[1]);
+            float_push(&uv, t, 2);
+        } else if (line[0] == 'f' && line[1] == ' ') {
+            const char *cursor = line + 2;
+            MeshVertex  first, prev, cur;
+            int         corners = 0;
+            while (*cursor) {
+                while (*cursor == ' ' || *cursor == '\t') cursor++;
+                if (*cursor == '\0' || *cursor == '\n' || *cursor == '\r') break;
+                if (!parse_corner(&cursor, &pos, &uv, &cur)) {
+                    fprintf(stderr, "%s:%d: bad face index\n", path, line_number);
+                    ok = false;
+                    break;
+                }
+                if (corners == 0) first = cur;
+                if (corners >= 2) {
+                    vertex_push(mesh, &capacity, first);
+                    vertex_push(mesh, &capacity, prev);
+                    vertex_push(mesh, &capacity, cur);
+                }
+                prev = cur;
+                corners++;
+            }
+        }
+    }
+    fclose(file);
+    free(pos.data);
+    free(uv.data);
+
+    if (ok && mesh->vertex_count == 0) {
+        fprintf(stderr, "%s: no faces\n", path);
+        ok = false;
+    }
+
+    // One vertex per corner for now
+    mesh->index_count = mesh->vertex_count;
+    mesh->indices     = malloc((size_t)mesh->index_count * sizeof(uint32_t));
+    for (uint32_t i = 0; i < mesh->index_count; i++) mesh->indices[i] = i;
+    return ok;
+}
@@ -0,0 +1,231 @@
+#include "meshimport.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+void import_mesh_free(ImportMesh *mesh) {
+    free(mesh->vertices);
+    free(mesh->indices);
+    *mesh = (ImportMesh){0};
+}
+
+// --- Welding -----------------------------------------------------------------
+
+static uint32_t hash_vertex(const MeshVertex *v) {
+    // FNV-1a over the raw bytes
+    const uint8_t *p = (const uint8_t *)v;
+    uint32_t       h = 2166136261u;
+    for (size_t i = 0; i < sizeof(*v); i++) h = (h ^ p[i]) * 16777619u;
+    return h;
+}
+
+void mesh_weld(ImportMesh *mesh) {
+    uint32_t table_size = 1;
+    while (table_size < mesh->vertex_count * 2) table_size <<= 1;
+    uint32_t *table = malloc((size_t)table_size * sizeof(uint32_t));
+    memset(table, 0xFF, (size_t)table_size * sizeof(uint32_t));
+
+    uint32_t *remap  = malloc((size_t)mesh->vertex_count * sizeof(uint32_t));
+    uint32_t  unique = 0;
+    for (uint32_t i = 0; i < mesh->vertex_count; i++) {
+        const MeshVertex *v    = &mesh->vertices[i];
+        uint32_t          slot = hash_vertex(v) & (table_size - 1);
+        // Linear probing; the table is at most half full
+        while (table[slot] != UINT32_MAX && memcmp(&mesh->vertices[table[slot]], v, sizeof(*v)) != 0) {
+            slot = (slot + 1) & (table_size - 1);
+        }
+        if (table[slot] == UINT32_MAX) {
+            // Compact in place: unique <= i, so the slot being written is done
+            mesh->vertices[unique] = *v;
+            table[slot] = unique++;
+        }
+        remap[i] = table[slot];
+    }
+
+    for (uint32_t i = 0; i < mesh->index_count; i++) mesh->indices[i] = remap[mesh->indices[i]];
+    mesh->vertex_count = unique;
+
+    free(remap);
+    free(table);
+}
+
+// --- Post-transform cache order (Forsyth) -----------------------------------
+//
+// Greedily emits the triangle with the highest score, where a vertex scores
+// higher the more recently it entered the simulated LRU cache and the fewer
+// triangles still use it (so lone leftovers are finished off early).
+// See Tom Forsyth, "Linear-Speed Vertex Cache Optimisation".
+
+#define FORSYTH_CACHE_DECAY_POWER   1.5f
+#define FORSYTH_LAST_TRI_SCORE      0.75f
+#define FORSYTH_VALENCE_BOOST_SCALE 2.0f
+#define FORSYTH_VALENCE_BOOST_POWER 0.5f
+
+static float vertex_score(int cache_pos, uint32_t remaining) {
+    if (remaining == 0) return -1.0f;
+
+    float score = 0.0f;
+    if (cache_pos >= 0) {
+        if (cache_pos < 3) {
+            // Used by the last triangle: fixed score, no point favouring order
+            score = FORSYTH_LAST_TRI_SCORE;
+        } else {
+            float scale = 1.0f / (VCACHE_SIZE - 3);
+            score = powf(1.0f - (float)(cache_pos - 3) * scale, FORSYTH_CACHE_DECAY_POWER);
+        }
+    }
+    return score + FORSYTH_VALENCE_BOOST_SCALE * powf((float)remaining, -FORSYTH_VALENCE_BOOST_POWER);
+}
+
+void mesh_optimize_vcache(ImportMesh *mesh) {
+    uint32_t tri_count = mesh->index_count / 3;
+    uint32_t vcount    = mesh->vertex_count;
+    if (tri_count == 0) return;
+
+    // Vertex -> triangle adjacency (CSR). adj_count shrinks as triangles are
+    // emitted; live triangles are kept at the front of each list.
+    uint32_t *adj_offset = calloc((size_t)vcount + 1, sizeof(uint32_t));
+    uint32_t *adj_count  = calloc(vcount, sizeof(uint32_t));
+    uint32_t *adj        = malloc((size_t)mesh->index_count * sizeof(uint32_t));
+    for (uint32_t i = 0; i < mesh->index_count; i++) adj_count[mesh->indices[i]]++;
+    for (uint32_t v = 0; v < vcount; v++) adj_offset[v + 1] = adj_offset[v] + adj_count[v];
+    memset(adj_count, 0, (size_t)vcount * sizeof(uint32_t));
+    for (uint32_t i = 0; i < mesh->index_count; i++) {
+        uint32_t v = mesh->indices[i];
+        adj[adj_offset[v] + adj_count[v]++] = i / 3;
+    }
+
+    int      *cache_pos = malloc((size_t)vcount * sizeof(int));
+    float    *vscore    = malloc((size_t)vcount * sizeof(float));
+    float    *tscore    = calloc(tri_count, sizeof(float));
+    bool     *emitted   = calloc(tri_count, sizeof(bool));
+    uint32_t *out       = malloc((size_t)mesh->index_count * sizeof(uint32_t));
+    for (uint32_t v = 0; v < vcount; v++) {
+        cache_pos[v] = -1;
+        vscore[v]    = vertex_score(-1, adj_count[v]);
+    }
+    for (uint32_t t = 0; t < tri_count; t++) {
+        for (int k = 0; k < 3; k++) tscore[t] += vscore[mesh->indices[t * 3 + k]];
+    }
+
+    // Three slots of headroom for the vertices of the triangle just emitted
+    uint32_t cache[VCACHE_SIZE + 3], next_cache[VCACHE_SIZE + 3];
+    uint32_t cache_count = 0;
+    uint32_t scan        = 0;   // all triangles before this are emitted
+    int64_t  best        = -1;
+
+    for (uint32_t emitted_count = 0; emitted_count < tri_count; emitted_count++) {
+        if (best < 0) {
+            // Nothing left around the cache: restart at the first remaining
+            // triangle rather than rescanning them all, to stay linear
+            while (emitted[scan]) scan++;
+            best = scan;
+        }
+
+        uint32_t        tri = (uint32_t)best;
+        const uint32_t *tv  = &mesh->indices[tri * 3];
+        memcpy(&out[emitted_count * 3], tv, 3 * sizeof(uint32_t));
+        emitted[tri] = true;
+
+        // Drop the triangle from its vertices' live lists
+        for (int k = 0; k < 3; k++) {
+            uint32_t  v    = tv[k];
+            uint32_t *list = &adj[adj_offset[v]];
+            for (uint32_t i = 0; i < adj_count[v]; i++) {
+                if (list[i] == tri) {
+                    list[i] = list[--adj_count[v]];
+                    break;
+                }
+            }
+        }
+
+        // New LRU order: this triangle's vertices first, then the old cache
+        uint32_t next_count = 0;
+        for (int k = 0; k < 3; k++) next_cache[next_count++] = tv[k];
+        for (uint32_t i = 0; i < cache_count; i++) {
+            uint32_t v = cache[i];
+            if (v != tv[0] && v != tv[1] && v != tv[2]) next_cache[next_count++] = v;
+        }
+        for (uint32_t i = 0; i < next_count; i++) {
+            uint32_t v = next_cache[i];
+            cache_pos[v] = i < VCACHE_SIZE ? (int)i : -1;
+            vscore[v]    = vertex_score(cache_pos[v], adj_count[v]);
+        }
+        cache_count = next_count < VCACHE_SIZE ? next_count : VCACHE_SIZE;
+        memcpy(cache, next_cache, cache_count * sizeof(uint32_t));
+
+        // Rescore triangles touching the cache and pick the next best there
+        best = -1;
+        float best_score = -1.0f;
+        for (uint32_t i = 0; i < next_count; i++) {
+            uint32_t        v    = next_cache[i];
+            const uint32_t *list = &adj[adj_offset[v]];
+            for (uint32_t j = 0; j < adj_count[v]; j++) {
+                uint32_t        t   = list[j];
+                const uint32_t *tvv = &mesh->indices[t * 3];
+                tscore[t] = vscore[tvv[0]] + vscore[tvv[1]] + vscore[tvv[2]];
+                if (tscore[t] > best_score) {
+                    best_score = tscore[t];
+                    best       = t;
+                }
+            }
+        }
+    }
+
+    memcpy(mesh->indices, out, (size_t)mesh->index_count * sizeof(uint32_t));
+
+    free(out);
+    free(emitted);
+    free(tscore);
+    free(vscore);
+    free(cache_pos);
+    free(adj);
+    free(adj_count);
+    free(adj_offset);
+}
+
+// --- Vertex fetch order ------------------------------------------------------
+
+void mesh_optimize_vfetch(ImportMesh *mesh) {
+    uint32_t *remap = malloc((size_t)mesh->vertex_count * sizeof(uint32_t));
+    memset(remap, 0xFF, (size_t)mesh->vertex_count * sizeof(uint32_t));
+    MeshVertex *vertices = malloc((size_t)mesh->vertex_count * sizeof(MeshVertex));
+
+    uint32_t next = 0;
+    for (uint32_t i = 0; i < mesh->index_count; i++) {
+        uint32_t v = mesh->indices[i];
+        if (remap[v] == UINT32_MAX) {
+            remap[v] = next;
+            vertices[next++] = mesh->vertices[v];
+        }
+        mesh->indices[i] = remap[v];
+    }
+
+    free(mesh->vertices);
+    mesh->vertices     = vertices;
+    mesh->vertex_count = next;
+    free(remap);
+}
+
+// --- Statistics --------------------------------------------------------------
+
+float mesh_acmr(const ImportMesh *mesh, uint32_t cache_size) {
+    uint32_t tri_count = mesh->index_count / 3;
+    if (tri_count == 0) return 0.0f;
+
+    // A vertex is in the FIFO iff fewer than cache_size misses happened since
+    // it was last inserted
+    uint32_t *inserted = malloc((size_t)mesh->vertex_count * sizeof(uint32_t));
+    bool     *seen     = calloc(mesh->vertex_count, sizeof(bool));
+    uint32_t  misses   = 0;
+    for (uint32_t i = 0; i < mesh->index_count; i++) {
+        uint32_t v = mesh->indices[i];
+        if (!seen[v] || misses - inserted[v] >= cache_size) {
+            seen[v]     = true;
+            inserted[v] = misses++;
+        }
+    }
+    free(seen);
+    free(inserted);
+    return (float)misses / (float)tri_count;
+}
@@ -0,0 +1,243 @@
+#include "meshimport.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+// --- Quadric error simplification -------------------------------------------
+//
+// Each vertex accumulates the planes of the triangles around it; moving it to
+// p costs the summed squared distance from p to those planes. Edges collapse
+// onto one of their endpoints, cheapest first, so no vertex is created and
+// every LOD indexes the original vertex buffer. See Garland and Heckbert,
+// "Surface Simplification Using Quadric Error Metrics".
+//
+// The quadric only ranks collapses. The reported error is geometric: how far
+// each removed vertex lies from the triangles that replace its fan, added up
+// over the collapses that shaped that patch of surface.
+//
+// Vertices on open borders and UV seams never move, so outlines and texture
+// mapping survive; a mesh made only of those stops simplifying early.
+
+// Symmetric 4x4 plane quadric, upper triangle
+typedef struct {
+    double a2, ab, ac, ad, b2, bc, bd, c2, cd, d2;
+} Quadric;
+
+typedef struct {
+    float    cost;
+    uint32_t from;
+    uint32_t to;
+} Collapse;
+
+static void quadric_add(Quadric *q, const Quadric *r) {
+    q->a2 += r->a2; q->ab += r->ab; q->ac += r->ac; q->ad += r->ad; q->b2 += r->b2;
+    q->bc += r->bc; q->bd += r->bd; q->c2 += r->c2; q->cd += r->cd; q->d2 += r->d2;
+}
+
+static double quadric_eval(const Quadric *q, const float p[3]) {
+    double x = p[0], y = p[1], z = p[2];
+    return q->a2 * x * x + 2.0 * q->ab * x * y + 2.0 * q->ac * x * z + 2.0 * q->ad * x
+         + q->b2 * y * y + 2.0 * q->bc * y * z + 2.0 * q->bd * y
+         + q->c2 * z * z + 2.0 * q->cd * z
+         + q->d2;
+}
+
+static void triangle_normal(const float *a, const float *b, const float *c, double n[3]) {
+    double u[3] = { b[0] - a[0], b[1] - a[1], b[2] - a[2] };
+    double v[3] = { c[0] - a[0], c[1] - a[1], c[2] - a[2] };
+    n[0] = u[1] * v[2] - u[2] * v[1];
+    n[1] = u[2] * v[0] - u[0] * v[2];
+    n[2] = u[0] * v[1] - u[1] * v[0];
+}
+
+static int compare_u64(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return x < y ? -1 : x > y;
+}
+
+static int compare_collapse(const void *a, const void *b) {
+    float x = ((const Collapse *)a)->cost, y = ((const Collapse *)b)->cost;
+    return x < y ? -1 : x > y;
+}
+
+// The lowest-numbered vertex at each vertex's position, so vertices split
+// only by their UVs count as one
+static void position_representatives(const ImportMesh *mesh, uint32_t *rep) {
+    uint32_t table_size = 1;
+    while (table_size < mesh->vertex_count * 2) table_size <<= 1;
+    uint32_t *table = malloc((size_t)table_size * sizeof(uint32_t));
+    memset(table, 0xFF, (size_t)table_size * sizeof(uint32_t));
+    for (uint32_t i = 0; i < mesh->vertex_count; i++) {
+        const float *p = mesh->vertices[i].position;
+        uint32_t     h = 2166136261u;
+        for (size_t k = 0; k < sizeof(float) * 3; k++) h = (h ^ ((const uint8_t *)p)[k]) * 16777619u;
+        uint32_t slot = h & (table_size - 1);
+        while (table[slot] != UINT32_MAX && memcmp(mesh->vertices[table[slot]].position, p, sizeof(float) * 3) != 0) {
+            slot = (slot + 1) & (table_size - 1);
+        }
+        if (table[slot] == UINT32_MAX) table[slot] = i;
+        rep[i] = table[slot];
+    }
+    free(table);
+}
+
+// Lock vertices on UV seams (a position shared by several vertices) and on
+// open borders (an edge between positions used by one triangle only)
+static void find_locked(const ImportMesh *mesh, const uint32_t *indices, uint32_t index_count,
+                        const uint32_t *rep, bool *locked) {
+    uint32_t *variants = calloc(mesh->vertex_count, sizeof(uint32_t));
+    for (uint32_t i = 0; i < mesh->vertex_count; i++) variants[rep[i]]++;
+
+    uint64_t *edges = malloc((size_t)index_count * sizeof(uint64_t));
+    for (uint32_t i = 0; i < index_count; i++) {
+        uint32_t a = rep[indices[i]];
+        uint32_t b = rep[indices[i - i % 3 + (i + 1) % 3]];
+        edges[i] = a < b ? (uint64_t)a << 32 | b : (uint64_t)b << 32 | a;
+    }
+    qsort(edges, index_count, sizeof(uint64_t), compare_u64);
+    bool *border = calloc(mesh->vertex_count, sizeof(bool));
+    for (uint32_t i = 0; i < index_count;) {
+        uint32_t run = 1;
+        while (i + run < index_count && edges[i + run] == edges[i]) run++;
+        if (run == 1) {
+            border[edges[i] >> 32]        = true;
+            border[edges[i] & 0xFFFFFFFF] = true;
+        }
+        i += run;
+    }
+
+    for (uint32_t i = 0; i < mesh->vertex_count; i++) locked[i] = variants[rep[i]] > 1 || border[rep[i]];
+    free(border);
+    free(edges);
+    free(variants);
+}
+
+uint32_t mesh_simplify(const ImportMesh *mesh, const uint32_t *indices, uint32_t index_count,
+                       uint32_t target_index_count, uint32_t *out, float *error) {
+    uint32_t  vertex_count = mesh->vertex_count;
+    uint32_t *rep          = malloc((size_t)vertex_count * sizeof(uint32_t));
+    bool     *locked       = malloc((size_t)vertex_count * sizeof(bool));
+    Quadric  *quadrics     = calloc(vertex_count, sizeof(Quadric));
+    uint32_t *remap        = malloc((size_t)vertex_count * sizeof(uint32_t));
+    bool     *touched      = malloc((size_t)vertex_count * sizeof(bool));
+    uint32_t *tri_start    = malloc(((size_t)vertex_count + 1) * sizeof(uint32_t));
+    uint32_t *tri_list     = malloc((size_t)index_count * sizeof(uint32_t));
+    Collapse *collapses    = malloc((size_t)index_count * sizeof(Collapse));
+    float    *vertex_error = calloc(vertex_count, sizeof(float));
+    position_representatives(mesh, rep);
+    find_locked(mesh, indices, index_count, rep, locked);
+    memcpy(out, indices, (size_t)index_count * sizeof(uint32_t));
+
+    for (uint32_t t = 0; t + 3 <= index_count; t += 3) {
+        const float *p[3];
+        for (int k = 0; k < 3; k++) p[k] = mesh->vertices[indices[t + k]].position;
+        double n[3];
+        triangle_normal(p[0], p[1], p[2], n);
+        double len = sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+        if (len == 0.0) continue;
+        double a = n[0] / len, b = n[1] / len, c = n[2] / len;
+        double d = -(a * p[0][0] + b * p[0][1] + c * p[0][2]);
+        Quadric q = { a * a, a * b, a * c, a * d, b * b, b * c, b * d, c * c, c * d, d * d };
+        for (int k = 0; k < 3; k++) quadric_add(&quadrics[indices[t + k]], &q);
+    }
+
+    float max_error = 0.0f;
+    while (index_count > target_index_count) {
+        // Triangles around each vertex
+        memset(tri_start, 0, ((size_t)vertex_count + 1) * sizeof(uint32_t));
+        for (uint32_t i = 0; i < index_count; i++) tri_start[out[i] + 1]++;
+        for (uint32_t v = 0; v < vertex_count; v++) tri_start[v + 1] += tri_start[v];
+        for (uint32_t i = 0; i < index_count; i++) tri_list[tri_start[out[i]]++] = i / 3;
+        for (uint32_t v = vertex_count; v > 0; v--) tri_start[v] = tri_start[v - 1];
+        tri_start[0] = 0;
+
+        // Every directed edge from an unlocked vertex is a candidate
+        uint32_t candidates = 0;
+        for (uint32_t i = 0; i < index_count; i++) {
+            uint32_t from = out[i], to = out[i - i % 3 + (i + 1) % 3];
+            if (locked[from]) continue;
+            Quadric q = quadrics[from];
+            quadric_add(&q, &quadrics[to]);
+            collapses[candidates++] = (Collapse){
+                .cost = (float)quadric_eval(&q, mesh->vertices[to].position),
+                .from = from,
+                .to   = to,
+            };
+        }
+        qsort(collapses, candidates, sizeof(Collapse), compare_collapse);
+
+        // Cheapest first, each vertex's neighbourhood changed at most once
+        // per pass so the adjacency above stays valid
+        for (uint32_t v = 0; v < vertex_count; v++) remap[v] = v;
+        memset(touched, 0, (size_t)vertex_count * sizeof(bool));
+        uint32_t removed = 0, needed = (index_count - target_index_count) / 3;
+        for (uint32_t c = 0; c < candidates && removed < needed; c++) {
+            uint32_t from = collapses[c].from, to = collapses[c].to;
+            if (touched[from] || touched[to]) continue;
+
+            // Reject collapses that would fold a triangle over, and measure
+            // how far the surface moves
+            const float *removed_at = mesh->vertices[from].position;
+            bool         flips      = false;
+            uint32_t     gone       = 0;
+            double       distance   = 0.0;
+            for (uint32_t k = tri_start[from]; k < tri_start[from + 1] && !flips; k++) {
+                const uint32_t *tri = &out[tri_list[k] * 3];
+                if (tri[0] == to || tri[1] == to || tri[2] == to) {
+                    gone++;
+                    continue;
+                }
+                const float *p[3], *q[3];
+                for (int j = 0; j < 3; j++) {
+                    p[j] = mesh->vertices[tri[j]].position;
+                    q[j] = mesh->vertices[tri[j] == from ? to : tri[j]].position;
+                }
+                double before[3], after[3];
+                triangle_normal(p[0], p[1], p[2], before);
+                triangle_normal(q[0], q[1], q[2], after);
+                flips = before[0] * after[0] + before[1] * after[1] + before[2] * after[2] <= 0.0;
+                double len = sqrt(after[0] * after[0] + after[1] * after[1] + after[2] * after[2]);
+                double d   = fabs(after[0] * (removed_at[0] - q[0][0]) + after[1] * (removed_at[1] - q[0][1]) +
+                                  after[2] * (removed_at[2] - q[0][2])) / len;
+                if (d > distance) distance = d;
+            }
+            if (flips) continue;
+
+            remap[from] = to;
+            quadric_add(&quadrics[to], &quadrics[from]);
+            float patch = (vertex_error[from] > vertex_error[to] ? vertex_error[from] : vertex_error[to]) +
+                          (float)distance;
+            vertex_error[to] = patch;
+            if (patch > max_error) max_error = patch;
+            for (uint32_t k = tri_start[from]; k < tri_start[from + 1]; k++) {
+                const uint32_t *tri = &out[tri_list[k] * 3];
+                for (int j = 0; j < 3; j++) touched[tri[j]] = true;
+            }
+            removed += gone;
+        }
+        if (removed == 0) break;
+
+        // Apply, dropping triangles that lost a corner
+        uint32_t count = 0;
+        for (uint32_t t = 0; t < index_count; t += 3) {
+            uint32_t a = remap[out[t]], b = remap[out[t + 1]], c = remap[out[t + 2]];
+            if (a == b || b == c || c == a) continue;
+            out[count++] = a;
+            out[count++] = b;
+            out[count++] = c;
+        }
+        index_count = count;
+    }
+
+    free(vertex_error);
+    free(collapses);
+    free(tri_list);
+    free(tri_start);
+    free(touched);
+    free(remap);
+    free(quadrics);
+    free(locked);
+    free(rep);
+    *error = max_error;
+    return index_count;
+}
@@ -0,0 +1,101 @@
+// Offline texture cooker: decodes an image once, generates the full mip chain
+// and writes it in the texture cache format (see texture_cache.h).
+//
+//   texcook <input.png> <output.tex>
+#include "texture_cache.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+
+static uint32_t align_up(uint32_t v) {
+    return (v + TEXCACHE_ALIGN - 1) & ~(uint32_t)(TEXCACHE_ALIGN - 1);
+}
+
+// 2x2 box filter. Odd source sizes clamp the last row/column.
+static void downsample(const uint8_t *src, int sw, int sh, uint8_t *dst, int dw, int dh) {
+    for (int y = 0; y < dh; y++) {
+        int y0 = y * 2;
+        int y1 = y0 + 1 < sh ? y0 + 1 : y0;
+        for (int x = 0; x < dw; x++) {
+            int x0 = x * 2;
+            int x1 = x0 + 1 < sw ? x0 + 1 : x0;
+            for (int c = 0; c < 4; c++) {
+                int sum = src[(y0 * sw + x0) * 4 + c] + src[(y0 * sw + x1) * 4 + c]
+                        + src[(y1 * sw + x0) * 4 + c] + src[(y1 * sw + x1) * 4 + c];
+                dst[(y * dw + x) * 4 + c] = (uint8_t)((sum + 2) / 4);
+            }
+        }
+    }
+}
+
+int main(int argc, char *argv[]) {
+    if (argc != 3) {
+        fprintf(stderr, "usage: %s <input.png> <output.tex>\n", argv[0]);
+        return 1;
+    }
+
+    // Match the runtime PNG path, which flips on load
+    stbi_set_flip_vertically_on_load(1);
+    int width, height, channels;
+    uint8_t *pixels = stbi_load(argv[1], &width, &height, &channels, 4);
+    if (!pixels) {
+        fprintf(stderr, "%s: %s\n", argv[1], stbi_failure_reason());
+        return 1;
+    }
+    if (width > TEXCACHE_MAX_SIZE || height > TEXCACHE_MAX_SIZE) {
+        fprintf(stderr, "%s: %dx%d is over the %d texel limit\n", argv[1], width, height, TEXCACHE_MAX_SIZE);
+        stbi_image_free(pixels);
+        return 1;
+    }
+
+    TexCacheHeader header = {
+        .magic   = TEXCACHE_MAGIC,
+        .version = TEXCACHE_VERSION,
+        .width   = (uint32_t)width,
+        .height  = (uint32_t)height,
+    };
+
+    // Lay out the chain down to 1x1
+    uint32_t offset = align_up(sizeof(header));
+    int w = width, h = height;
+    while (header.num_mips < TEXCACHE_MAX_MIPS) {
+        TexCacheMip *mip = &header.mips[header.num_mips++];
+        mip->offset = offset;
+        mip->size   = (uint32_t)(w * h * 4);
+        offset      = align_up(offset + mip->size);
+        if (w == 1 && h == 1) break;
+        w = w > 1 ? w / 2 : 1;
+        h = h > 1 ? h / 2 : 1;
+    }
+
+    uint8_t *file = calloc(1, offset);
+    if (!file) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+    memcpy(file, &header, sizeof(header));
+    memcpy(file + header.mips[0].offset, pixels, header.mips[0].size);
+    stbi_image_free(pixels);
+
+    w = width, h = height;
+    for (uint32_t i = 1; i < header.num_mips; i++) {
+        int dw = w > 1 ? w / 2 : 1;
+        int dh = h > 1 ? h / 2 : 1;
+        downsample(file + header.mips[i - 1].offset, w, h, file + header.mips[i].offset, dw, dh);
+        w = dw, h = dh;
+    }
+
+    FILE *out = fopen(argv[2], "wb");
+    if (!out || fwrite(file, 1, offset, out) != offset) {
+        fprintf(stderr, "%s: write failed\n", argv[2]);
+        return 1;
+    }
+    fclose(out);
+    free(file);
+
+    printf("%s: %dx%d, %u mips, %u bytes\n", argv[2], width, height, header.num_mips, offset);
+    return 0;
+}